@@ -0,0 +1,75 @@
+# Generates C source with table of OpenCL programs, embedded into SCOW
+# library. Each program is embedded as SPIR-V module (if it was compiled) & as
+# OpenCL C source, which is used on Devices without IL support.
+#
+# Usage:
+#   cmake -DOUTPUT=<file.c> -DNAMES=<a|b> -DSOURCES=<a.cl|b.cl>
+#         [-DIL_FILES=<a.spv|b.spv>] -P EmbedIL.cmake
+#
+# Lists are separated by '|', as ';' doesn't survive custom commands.
+
+function(bytes_to_c_array file var_name out_code out_size)
+  file(READ ${file} hex HEX)
+  string(LENGTH "${hex}" hex_length)
+  math(EXPR size "${hex_length} / 2")
+
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+  # CMake regular expressions have no counted repetition, so row is spelled out
+  set(row "")
+  foreach(i RANGE 1 12)
+    set(row "${row}0x[0-9a-f][0-9a-f],")
+  endforeach()
+  string(REGEX REPLACE "(${row})" "\\1\n    " bytes "${bytes}")
+
+  # Trailing zero makes array usable as C string as well
+  set(${out_code}
+    "static const unsigned char ${var_name}[] = {\n    ${bytes}0x00\n};\n\n"
+    PARENT_SCOPE)
+  set(${out_size} ${size} PARENT_SCOPE)
+endfunction()
+
+string(REPLACE "|" ";" names "${NAMES}")
+string(REPLACE "|" ";" sources "${SOURCES}")
+string(REPLACE "|" ";" il_files "${IL_FILES}")
+
+list(LENGTH names num_programs)
+list(LENGTH il_files num_il_files)
+
+set(code "/* Generated by EmbedIL.cmake, don't edit. */\n\n")
+set(code "${code}#include \"embedded_il.h\"\n\n")
+set(table "")
+
+if(num_programs GREATER 0)
+  math(EXPR last_program "${num_programs} - 1")
+
+  foreach(i RANGE ${last_program})
+    list(GET names ${i} name)
+    list(GET sources ${i} source)
+
+    bytes_to_c_array(${source} "source_${i}" source_code source_size)
+    set(code "${code}${source_code}")
+
+    if(num_il_files EQUAL num_programs)
+      list(GET il_files ${i} il_file)
+      bytes_to_c_array(${il_file} "il_${i}" il_code il_size)
+      set(code "${code}${il_code}")
+      set(table "${table}    { \"${name}\", il_${i}, ${il_size}, ")
+    else()
+      set(table "${table}    { \"${name}\", 0, 0, ")
+    endif()
+
+    set(table "${table}(const char*) source_${i} },\n")
+  endforeach()
+endif()
+
+set(code "${code}const scow_Embedded_IL scow_embedded_il_table[] =\n{\n")
+set(code "${code}${table}    { 0, 0, 0, 0 }\n};\n")
+
+# Output is rewritten only if changed, not to rebuild library needlessly
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} old_code)
+endif()
+
+if(NOT "${old_code}" STREQUAL "${code}")
+  file(WRITE ${OUTPUT} "${code}")
+endif()
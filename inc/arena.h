@@ -0,0 +1,117 @@
+/*
+ * @file arena.h
+ * @brief Provides sub-allocation of aligned sub-buffers from one OpenCL buffer
+ *
+ * @see arena.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_ARENA_H_
+#define CL_ARENA_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "mem_object.h"
+
+/*! \def VOID_ARENA_PTR
+ * Void pointer to Arena
+ */
+#undef VOID_ARENA_PTR
+#define VOID_ARENA_PTR      ((scow_Arena*)0x0)
+
+struct scow_Steel_Thread;
+
+/*! \cond PRIVATE */
+// Freed range of arena buffer, which isn't adjacent to top
+typedef struct Arena_Block
+{
+    size_t origin, size;
+    struct Arena_Block* next;
+} Arena_Block;
+/*! \endcond */
+
+/*! \struct scow_Arena
+ *
+ *  This structure reserves one OpenCL buffer & carves sub-buffers out of it,
+ *  so that many small memory objects share single allocation. Origins of
+ *  sub-buffers are aligned to base address alignment of Device.
+ *
+ *  Sub-buffers are allocated from top of arena in O(1). Freed sub-buffers
+ *  are merged with their neighbours & reused by first fit; freed top of arena
+ *  is given back at once. Reset() frees whole arena at once, e. g. per frame.
+ *
+ *  Arena isn't thread-safe.
+ */
+typedef struct scow_Arena
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    scow_Mem_Object* buffer;
+    /*!< Memory Object, which sub-buffers are made from. */
+
+    size_t alignment;
+    /*!< Alignment of sub-buffer origins in bytes. */
+
+    size_t top;
+    /*!< Offset in bytes, above which arena is free. */
+
+    size_t used;
+    /*!< Amount of memory in bytes, taken by live sub-buffers. */
+
+    /*! \cond PRIVATE */
+    Arena_Block* free_blocks;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    scow_Mem_Object* (*Alloc)(struct scow_Arena *self, cl_mem_flags mem_flags,
+            size_t size);
+    /*!< Points on Arena_Alloc(). */
+
+    ret_code (*Free)(struct scow_Arena *self, scow_Mem_Object *child);
+    /*!< Points on Arena_Free(). */
+
+    ret_code (*Reset)(struct scow_Arena *self);
+    /*!< Points on Arena_Reset(). */
+
+    ret_code (*Destroy)(struct scow_Arena *self);
+    /*!< Points on Arena_Destroy(). */
+    /*!@}*/
+
+} scow_Arena;
+
+/*!
+ * This function allocates memory for structure, reserves OpenCL buffer &
+ * sets function pointers.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives context.
+ * @param[in] mem_flags OpenCL memory flags of arena buffer.
+ * @param[in] size size of arena buffer in bytes.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_ARENA_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Arena* Make_Arena(struct scow_Steel_Thread *parent_thread,
+        cl_mem_flags mem_flags, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_ARENA_H_ */
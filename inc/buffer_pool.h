@@ -0,0 +1,169 @@
+/*
+ * @file buffer_pool.h
+ * @brief Provides pool of OpenCL buffers, recycled by size classes
+ *
+ * @see buffer_pool.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_BUFFER_POOL_H_
+#define CL_BUFFER_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <pthread.h>
+
+#include "error.h"
+
+/*! \def VOID_BUFFER_POOL_PTR
+ * Void pointer to Buffer Pool
+ */
+#undef VOID_BUFFER_POOL_PTR
+#define VOID_BUFFER_POOL_PTR        ((scow_Buffer_Pool*)0x0)
+
+/*! \def BUFFER_POOL_MIN_CLASS_LOG2
+ * Binary logarithm of the smallest size class. Smaller buffers take it.
+ */
+#undef BUFFER_POOL_MIN_CLASS_LOG2
+#define BUFFER_POOL_MIN_CLASS_LOG2  (8)
+
+/*! \def BUFFER_POOL_NUM_CLASSES
+ * Number of size classes
+ */
+#undef BUFFER_POOL_NUM_CLASSES
+#define BUFFER_POOL_NUM_CLASSES     (8 * sizeof(size_t))
+
+/*! \def BUFFER_POOL_NUM_FENCES
+ * Number of queues of Steel Thread, which free buffer is fenced on
+ */
+#undef BUFFER_POOL_NUM_FENCES
+#define BUFFER_POOL_NUM_FENCES      (4)
+
+struct scow_Steel_Thread;
+
+/*! \cond PRIVATE */
+/* Free OpenCL buffer, kept in pool. Commands, enqueued before buffer was
+ * returned, may still use it, so it's reused only when markers, enqueued
+ * after them, are complete. */
+typedef struct Buffer_Pool_Entry
+{
+    cl_mem mem;
+    cl_mem_flags mem_flags;
+    cl_event fences[BUFFER_POOL_NUM_FENCES];
+    struct Buffer_Pool_Entry* next;
+} Buffer_Pool_Entry;
+/*! \endcond */
+
+/*! \struct scow_Buffer_Pool_Stats
+ *
+ * This structure contains statistics of Buffer Pool since its creation.
+ */
+typedef struct scow_Buffer_Pool_Stats
+{
+    cl_ulong num_hits;
+    /*!< Number of allocations, served by free buffers. */
+
+    cl_ulong num_misses;
+    /*!< Number of allocations, that created new OpenCL buffers. */
+
+    cl_ulong num_trimmed;
+    /*!< Number of free buffers, released to keep pool within budget. */
+
+    size_t cached_bytes;
+    /*!< Amount of memory in free buffers. */
+
+    size_t budget;
+    /*!< Maximal amount of memory in free buffers. */
+
+} scow_Buffer_Pool_Stats;
+
+/*! \struct scow_Buffer_Pool
+ *
+ *  This structure keeps free OpenCL buffers of parent Steel Thread for reuse.
+ *  Buffers are allocated by power of two size classes, so that buffer of
+ *  close size can be reused, & they are reused only with the same memory
+ *  flags. Memory objects, made by Make_Buffer() without Host pointer, take
+ *  their buffers from pool & return them back at destruction, if parent Steel
+ *  Thread has pool.
+ *
+ *  Amount of memory in free buffers is kept under budget: when buffer doesn't
+ *  fit, free buffers of the largest classes are released first.
+ *
+ *  Returned buffer is given to other user only after commands, which were
+ *  enqueued into queues of parent Steel Thread before its return, complete.
+ *  Commands, enqueued into other queues, must be finished before return.
+ *
+ *  Pool is thread-safe.
+ */
+typedef struct scow_Buffer_Pool
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    struct scow_Steel_Thread* parent_thread;
+    /*!< Parent Steel Thread, which gives context. */
+
+    /*! \cond PRIVATE */
+    pthread_mutex_t lock;
+    Buffer_Pool_Entry* free_lists[BUFFER_POOL_NUM_CLASSES];
+    scow_Buffer_Pool_Stats stats;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    cl_mem (*Acquire)(struct scow_Buffer_Pool *self, cl_mem_flags mem_flags,
+            size_t size, ret_code *ret);
+    /*!< Points on Buffer_Pool_Acquire(). */
+
+    ret_code (*Recycle)(struct scow_Buffer_Pool *self, cl_mem mem,
+            cl_mem_flags mem_flags);
+    /*!< Points on Buffer_Pool_Recycle(). */
+
+    ret_code (*Set_Budget)(struct scow_Buffer_Pool *self, size_t budget);
+    /*!< Points on Buffer_Pool_Set_Budget(). */
+
+    ret_code (*Trim)(struct scow_Buffer_Pool *self, size_t max_cached_bytes);
+    /*!< Points on Buffer_Pool_Trim(). */
+
+    ret_code (*Get_Stats)(struct scow_Buffer_Pool *self,
+            scow_Buffer_Pool_Stats *stats);
+    /*!< Points on Buffer_Pool_Get_Stats(). */
+
+    ret_code (*Destroy)(struct scow_Buffer_Pool *self);
+    /*!< Points on Buffer_Pool_Destroy(). */
+    /*!@}*/
+
+} scow_Buffer_Pool;
+
+/*!
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives context.
+ * @param[in] budget maximal amount of memory in bytes, kept in free buffers.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_BUFFER_POOL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Buffer_Pool* Make_Buffer_Pool(struct scow_Steel_Thread *parent_thread,
+        size_t budget);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_BUFFER_POOL_H_ */
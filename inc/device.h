@@ -124,8 +124,14 @@ typedef enum DEVICE_INFO_PARAM
     DEVICE_VERSION,
     /*!< OpenCL version, supported by Device. */
 
-    DRIVER_VERSION
-/*!< Version of OpenCL driver. */
+    DRIVER_VERSION,
+    /*!< Version of OpenCL driver. */
+
+    DEVICE_TYPE,
+    /*!< Type of Device: CPU, GPU, accelerator. */
+
+    DEVICE_HOST_UNIFIED_MEMORY
+/*!< Whether Device & Host share memory subsystem. */
 } DEVICE_INFO_PARAM;
 
 /*! \struct scow_Device
@@ -165,6 +171,12 @@ typedef struct scow_Device
     cl_device_exec_capabilities exec_capabilities;
     /*!< Describe execution capabilities of OpenCL Device. */
 
+    cl_device_type device_type;
+    /*!< Type of OpenCL Device. */
+
+    cl_bool host_unified_memory;
+    /*!< CL_TRUE if Device & Host share memory subsystem. */
+
     cl_uint max_compute_units,
     /*!< The number of parallel compute cores on the OpenCL Device. */
 
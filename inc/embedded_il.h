@@ -0,0 +1,65 @@
+/*
+ * @file embedded_il.h
+ * @brief Provides access to OpenCL programs, compiled to SPIR-V at build time
+ * & embedded into library
+ *
+ * @see embedded_il.c
+ * @see EmbedIL.cmake
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_EMBEDDED_IL_H_
+#define CL_EMBEDDED_IL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "typedefs.h"
+
+/*! \struct scow_Embedded_IL
+ *
+ *  This structure describes OpenCL program, embedded into library. Program is
+ *  kept both as SPIR-V module & as OpenCL C source, so that it can be built
+ *  on Devices, which don't consume intermediate language.
+ */
+typedef struct scow_Embedded_IL
+{
+    const char* name;
+    /*!< Name of program - name of .cl file without extension. */
+
+    const unsigned char* il;
+    /*!< SPIR-V module. NULL, if no SPIR-V compiler was found at build time. */
+
+    size_t il_size;
+    /*!< Size of SPIR-V module in bytes. */
+
+    const char* source;
+    /*!< OpenCL C source code of program. */
+
+} scow_Embedded_IL;
+
+/*!
+ * This function looks up program, embedded into library, by name.
+ *
+ * @param[in] name name of .cl file without extension.
+ *
+ * @return pointer to embedded program in case of success, NULL otherwise.
+ */
+const scow_Embedded_IL* Find_Embedded_IL(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_EMBEDDED_IL_H_ */
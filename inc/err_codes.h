@@ -123,6 +123,12 @@ extern "C" {
  */
 #undef BUFFER_NOT_ALLOCATED
 #define BUFFER_NOT_ALLOCATED            (FAILED_TO_CREATE_OBJ_BASE + 1)
+
+/*! \def CANT_ACCESS_FILE
+ * Can't open, resize or map file
+ */
+#undef CANT_ACCESS_FILE
+#define CANT_ACCESS_FILE                (FAILED_TO_CREATE_OBJ_BASE + 2)
 /**@}*/
 
 /*--------------------OpenCL-related error codes------------------------------*/
@@ -263,6 +269,24 @@ extern "C" {
  */
 #undef INVALID_EVENT
 #define INVALID_EVENT                   (OPENCL_RELATED_ERRORS_BASE + 22)
+
+/*! \def CANT_ACCESS_BINARY_CACHE
+ * Can't read or write OpenCL program binary in on-disk cache
+ */
+#undef CANT_ACCESS_BINARY_CACHE
+#define CANT_ACCESS_BINARY_CACHE        (OPENCL_RELATED_ERRORS_BASE + 23)
+
+/*! \def IL_NOT_SUPPORTED
+ * Device can't create OpenCL program from intermediate language (SPIR-V)
+ */
+#undef IL_NOT_SUPPORTED
+#define IL_NOT_SUPPORTED                (OPENCL_RELATED_ERRORS_BASE + 24)
+
+/*! \def SUB_BUFFER_MISALIGNED
+ * Origin of sub-buffer isn't aligned to base address alignment of Device
+ */
+#undef SUB_BUFFER_MISALIGNED
+#define SUB_BUFFER_MISALIGNED           (OPENCL_RELATED_ERRORS_BASE + 25)
 /**@}*/
 
 /*----------------------Parent-child error codes------------------------------*/
@@ -299,6 +323,12 @@ extern "C" {
  */
 #undef CANT_SET_DEFAULT_OBJ
 #define CANT_SET_DEFAULT_OBJ            (OBJECT_IN_USE_BASE + 3)
+
+/*! \def KERNEL_IN_USE
+ * All kernel instances are in use by other Host threads
+ */
+#undef KERNEL_IN_USE
+#define KERNEL_IN_USE                   (OBJECT_IN_USE_BASE + 4)
 /**@}*/
 
 /*--------------------------Accessor-related error codes----------------------*/
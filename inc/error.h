@@ -206,6 +206,20 @@ typedef struct scow_Error
  */
 scow_Error* Make_Error(void);
 
+/**
+ * This function initializes structure of type 'scow_Error', which is embedded
+ * into another structure, & sets function pointers.
+ *
+ * @param[out] self pointer to structure to initialize.
+ *
+ * @return pointer to initialized structure in case of success,
+ * \ref VOID_ERROR_PTR otherwise.
+ *
+ * @warning 'Destroy' function pointer doesn't free memory of structure, it's
+ * freed together with structure, which it's embedded into.
+ */
+scow_Error* Init_Error(scow_Error* self);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,87 @@
+/*
+ * @file file_buffer.h
+ * @brief Provides loading of files into buffers & storing buffers into files
+ *
+ * @see file_buffer.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_FILE_BUFFER_H_
+#define CL_FILE_BUFFER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "mem_object.h"
+
+/*! \def FILE_BUFFER_CHUNK_SIZE
+ * Size of chunk in bytes, by which file is streamed through staging memory.
+ * It's multiple of page size.
+ */
+#undef FILE_BUFFER_CHUNK_SIZE
+#define FILE_BUFFER_CHUNK_SIZE      (4 << 20)
+
+/*! \def FILE_BUFFER_NUM_SLOTS
+ * Number of staging slots, so that copying of one chunk overlaps transfer of
+ * another one.
+ */
+#undef FILE_BUFFER_NUM_SLOTS
+#define FILE_BUFFER_NUM_SLOTS       (2)
+
+/*!
+ * This function makes Buffer with content of file. File is mapped into memory,
+ * so that it isn't read into heap.
+ *
+ * If parent Steel Thread is in zero-copy mode, Buffer is made over mapped
+ * file with CL_MEM_USE_HOST_PTR. File isn't changed by Buffer writes, as
+ * mapping is private, & is unmapped when Buffer is released.
+ *
+ * Otherwise file is streamed into Buffer by chunks of
+ * \ref FILE_BUFFER_CHUNK_SIZE through ring of pinned staging slots, & pages
+ * of file are dropped as soon as they are copied, so that resident memory
+ * stays bounded regardless of file size.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives OpenCL context, etc
+ * @param[in] mem_flags OpenCL memory flags. Flags of Host pointer usage are
+ * ignored.
+ * @param[in] file_name path to file.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated
+ * by this function.
+ */
+scow_Mem_Object* Make_Buffer_From_File(struct scow_Steel_Thread *parent_thread,
+        cl_mem_flags mem_flags, const char *file_name);
+
+/*!
+ * This function stores content of Buffer into file, which is created or
+ * truncated. File is mapped into memory & filled directly in zero-copy mode
+ * of parent Steel Thread, or by chunks through staging slots otherwise.
+ *
+ * @param[in] buffer Buffer to store.
+ * @param[in] file_name path to file.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+ret_code Buffer_Write_To_File(scow_Mem_Object *buffer, const char *file_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_FILE_BUFFER_H_ */
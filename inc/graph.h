@@ -0,0 +1,180 @@
+/*
+ * @file graph.h
+ * @brief Provides recorded graphs of OpenCL commands with low overhead replay
+ *
+ * @see graph.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_GRAPH_H_
+#define CL_GRAPH_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "mem_object.h"
+
+/*! \def VOID_GRAPH_PTR
+ * Void pointer to Graph
+ */
+#undef VOID_GRAPH_PTR
+#define VOID_GRAPH_PTR          ((scow_Graph*)0x0)
+
+/*! \def GRAPH_MAX_DEPS
+ * Maximal number of nodes, which single node of graph can depend on
+ */
+#undef GRAPH_MAX_DEPS
+#define GRAPH_MAX_DEPS          (8)
+
+typedef enum GRAPH_NODE_TYPE
+{
+    /*! Kernel execution. */
+    GRAPH_NODE_KERNEL = 0,
+
+    /*! Transfer of whole buffer from Host to Device. */
+    GRAPH_NODE_WRITE,
+
+    /*! Transfer of whole buffer from Device to Host. */
+    GRAPH_NODE_READ,
+
+    /*! Copy of whole buffer to another one on Device. */
+    GRAPH_NODE_COPY
+} GRAPH_NODE_TYPE;
+
+/*! \cond PRIVATE */
+// Command, recorded with all parameters resolved
+typedef struct Graph_Node
+{
+    GRAPH_NODE_TYPE type;
+    cl_command_queue queue;
+
+    scow_Kernel* kernel;
+    // Bind generation of kernel, when node was recorded into command buffer
+    cl_ulong recorded_generation;
+    cl_uint work_dim;
+    size_t global_size[MAX_NUM_DIMENSIONS], local_size[MAX_NUM_DIMENSIONS];
+    cl_bool has_local_size;
+
+    scow_Mem_Object *mem_obj, *dest;
+    void* host_ptr;
+
+    cl_uint num_deps;
+    cl_uint deps[GRAPH_MAX_DEPS];
+
+    // Nobody depends on node, so replay is finished when all such nodes are
+    cl_bool is_sink;
+} Graph_Node;
+/*! \endcond */
+
+/*! \struct scow_Graph
+ *
+ *  This structure records sequence of kernel launches & buffer transfers with
+ *  dependencies between them & replays it by single call.
+ *
+ *  Each command is resolved at recording: queue, OpenCL kernel, ND sizes &
+ *  memory objects are fixed, so replay is tight enqueue loop. Only things,
+ *  that are allowed to change between replays, are kernel arguments (bind them
+ *  via 'Bind_Arg' function pointer of kernel) & Host pointers of transfers.
+ *
+ *  If Device supports cl_khr_command_buffer & graph consists of kernels in
+ *  single queue only, graph is recorded into OpenCL command buffer. It's
+ *  recorded again when kernel arguments are changed.
+ */
+typedef struct scow_Graph
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    struct scow_Steel_Thread* parent_steel_thread;
+    /*!< Parent Steel Thread. */
+
+    cl_uint num_nodes;
+    /*!< Number of recorded commands. */
+
+    cl_bool is_finalized;
+    /*!< Graph is closed for recording & ready for replay. */
+
+    /*! \cond PRIVATE */
+    Graph_Node* nodes;
+    cl_uint capacity;
+
+    // Events of commands during replay & of those, nobody depends on
+    cl_event *events, *sink_events;
+
+    // Event of previous replay
+    cl_event last_replay;
+
+    // OpenCL command buffer (if supported), opaque here not to require headers
+    void* cmd_buf;
+    cl_bool use_cmd_buf;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    ret_code (*Add_Kernel)(struct scow_Graph *self, scow_Kernel *kernel,
+            cl_command_queue queue, cl_uint num_deps, const cl_uint *deps,
+            cl_uint *node_id);
+    /*!< Points on Graph_Add_Kernel(). */
+
+    ret_code (*Add_Write)(struct scow_Graph *self, scow_Mem_Object *mem_obj,
+            cl_command_queue queue, const void *host_ptr, cl_uint num_deps,
+            const cl_uint *deps, cl_uint *node_id);
+    /*!< Points on Graph_Add_Write(). */
+
+    ret_code (*Add_Read)(struct scow_Graph *self, scow_Mem_Object *mem_obj,
+            cl_command_queue queue, void *host_ptr, cl_uint num_deps,
+            const cl_uint *deps, cl_uint *node_id);
+    /*!< Points on Graph_Add_Read(). */
+
+    ret_code (*Add_Copy)(struct scow_Graph *self, scow_Mem_Object *src,
+            scow_Mem_Object *dest, cl_command_queue queue, cl_uint num_deps,
+            const cl_uint *deps, cl_uint *node_id);
+    /*!< Points on Graph_Add_Copy(). */
+
+    ret_code (*Set_Host_Ptr)(struct scow_Graph *self, cl_uint node_id,
+            void *host_ptr);
+    /*!< Points on Graph_Set_Host_Ptr(). */
+
+    ret_code (*Finalize)(struct scow_Graph *self);
+    /*!< Points on Graph_Finalize(). */
+
+    ret_code (*Replay)(struct scow_Graph *self, cl_uint evt_wait_list_size,
+            const cl_event *evt_wait_list, cl_event *generated_evt);
+    /*!< Points on Graph_Replay(). */
+
+    ret_code (*Destroy)(struct scow_Graph *self);
+    /*!< Points on Graph_Destroy(). */
+    /*!@}*/
+
+} scow_Graph;
+
+/*!
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives Device,
+ * queues, etc.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_GRAPH_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. Kernels & memory objects, recorded in graph, must outlive it.
+ */
+scow_Graph* Make_Graph(struct scow_Steel_Thread *parent_steel_thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_GRAPH_H_ */
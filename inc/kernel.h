@@ -24,6 +24,7 @@ extern "C"
 #endif
 
 #include "timer.h"
+#include "program.h"
 
 /*! \def VOID_KERNEL_PTR
  * Void pointer to Kernel
@@ -52,18 +53,6 @@ extern "C"
 #define EXTERNAL_EVT_PRIORITY       (1)
 /*! \endcond */
 
-typedef enum OPENCL_SOURCES_MODE
-{
-    /*! Read kernel source from files. */
-    READ_FROM_FILES = 0,
-
-    /*! Read kernel source from string. */
-    READ_FROM_STRING,
-
-    /*! Load pre-built OpenCL program & make kernel from it. */
-    READ_FROM_BINARY
-} OPENCL_SOURCES_MODE;
-
 /*! \struct scow_Kernel_Arg
  *
  * This structure is used in Kernel launching mechanism. It contains
@@ -82,6 +71,20 @@ typedef struct scow_Kernel_Arg
 #define K_ARG(A) \
     { sizeof(A), (void*)&(A) }
 
+/*! \cond PRIVATE */
+// Value of kernel argument, bound since last enqueue
+typedef struct Kernel_Arg_Binding
+{
+    size_t size;
+    // Copy of argument value, NULL for arguments in local memory
+    void* value;
+    // Argument is bound at least once
+    cl_bool is_bound;
+    // Argument value was changed & has to be passed to OpenCL kernel
+    cl_bool is_dirty;
+} Kernel_Arg_Binding;
+/*! \endcond */
+
 /*! Callback, that can be called on particular OpenCL event status. */
 typedef void (*OpenCL_Callback)(cl_event event,
         cl_int event_command_exec_status, void* user_data);
@@ -93,6 +96,15 @@ typedef void (*OpenCL_Callback)(cl_event event,
  *    - Auto-initializing of the kernel by name & parent Steel Thread
  *    - Ability to measure kernel execution time
  *    - Ability to check available ND sizes before kernel execution
+ *    - Local work group size auto-tuning with persistent tuning database
+ *    - Local work group size selection by kernel resources & Device
+ *      properties without benchmarking
+ *    - Padding of global size to multiple of local one with real size passed
+ *      to kernel
+ *    - Persistent arguments binding: only arguments, changed since last
+ *      enqueue, are passed to OpenCL kernel
+ *    - Chunked launch of huge ND ranges along the slowest dimension, so that
+ *      partial results may be transferred while further chunks are computed
  *
  *  @see 'scow_Steel_Thread' structure description for details about parent
  *  OpenCL Steel Thread
@@ -108,10 +120,14 @@ typedef struct scow_Kernel
     /*!< Structure for time measurement. */
 
     cl_kernel kernel;
-    /*!< OpenCL kernel. */
+    /*!< OpenCL kernel. If program is built asynchronously, kernel is created
+     * at first use, so it's NULL until then. */
 
     cl_program program;
-    /*!< OpenCL program. */
+    /*!< OpenCL program, kernel is made from. */
+
+    scow_Program* parent_program;
+    /*!< Program, kernel is made from. Kernel holds reference to it. */
 
     cl_int exec_status;
     /*!< Kernel execution status. */
@@ -125,6 +141,23 @@ typedef struct scow_Kernel
 
     // This flag denotes what event to check, if we want to check kernel status
     cl_bool evt_check_priority;
+
+    // Bound arguments values, which are passed to OpenCL kernel at enqueue
+    Kernel_Arg_Binding* arg_bindings;
+    cl_uint num_arg_bindings;
+
+    // Incremented at each binding, so that recorded commands know they're stale
+    cl_ulong bind_generation;
+
+    // Local work group size is tuned at next enqueue
+    cl_bool autotune_local_size;
+
+    // Global size is padded & real one is passed as the last argument
+    cl_bool pad_global_size;
+
+    // Error & Timer are embedded, 'error' & 'timer' point on them
+    scow_Error error_storage;
+    scow_Timer timer_storage;
     /*! \endcond */
 
     char name[OCL_KERNEL_NAME_MAX_LEN];
@@ -141,8 +174,28 @@ typedef struct scow_Kernel
     Global_Work_Size[3],
     /*!< Global amount of work items in each dimension. */
 
-    Local_Work_Size[3];
+    Local_Work_Size[3],
     /*!< Size of local work group (if any) in each dimension. */
+
+    Real_Work_Size[3];
+    /*!< Amount of work items, that do real work, in each dimension. It's
+     * less than global one, if global size is padded. */
+    /*!@}*/
+
+    /*! @name Resources, kernel needs on Device.
+     * They are queried once, when OpenCL kernel is created. */
+    /*!@{*/
+    size_t work_group_size,
+    /*!< Maximal local work group size, kernel can be launched with. */
+
+    preferred_wg_size_multiple;
+    /*!< Local work group size should be multiple to this one. */
+
+    cl_ulong local_mem_size,
+    /*!< Amount of local memory in bytes, used by work group. */
+
+    private_mem_size;
+    /*!< Amount of private memory in bytes, used by work item. */
     /*!@}*/
 
     struct scow_Steel_Thread* parent_steel_thread;
@@ -156,11 +209,55 @@ typedef struct scow_Kernel
             const unsigned int *local_wg_size);
     /*!< Points on Kernel_Set_ND_Sizes(). */
 
+    ret_code (*Set_ND_Sizes_Autotune)(struct scow_Kernel *self,
+            const unsigned int dimensionality,
+            const unsigned int *global_wg_size);
+    /*!< Points on Kernel_Set_ND_Sizes_Autotune(). */
+
+    ret_code (*Set_ND_Sizes_Auto)(struct scow_Kernel *self,
+            const unsigned int dimensionality,
+            const unsigned int *global_wg_size);
+    /*!< Points on Kernel_Set_ND_Sizes_Auto(). */
+
+    ret_code (*Set_ND_Sizes_Padded)(struct scow_Kernel *self,
+            const unsigned int dimensionality,
+            const unsigned int *global_wg_size,
+            const unsigned int *local_wg_size);
+    /*!< Points on Kernel_Set_ND_Sizes_Padded(). */
+
     ret_code (*Launch)(struct scow_Kernel *self, cl_command_queue *queue,
             cl_uint evt_wait_list_size, const cl_event *evt_wait_list,
             cl_event *generated_evt, TIME_STUDY_MODE time_measure_mode, ...);
     /*!< Points on Kernel_Launch(). */
 
+    ret_code (*Bind_Arg)(struct scow_Kernel *self, const cl_uint arg_index,
+            const size_t arg_size, const void *ptr_to_arg);
+    /*!< Points on Kernel_Bind_Arg(). */
+
+    ret_code (*Launch_Bound)(struct scow_Kernel *self, cl_command_queue *queue,
+            cl_uint evt_wait_list_size, const cl_event *evt_wait_list,
+            cl_event *generated_evt, TIME_STUDY_MODE time_measure_mode);
+    /*!< Points on Kernel_Launch_Bound(). */
+
+    ret_code (*Launch_Array)(struct scow_Kernel *self, cl_command_queue *queue,
+            cl_uint evt_wait_list_size, const cl_event *evt_wait_list,
+            cl_event *generated_evt, TIME_STUDY_MODE time_measure_mode,
+            const scow_Kernel_Arg *args);
+    /*!< Points on Kernel_Launch_Array(). */
+
+    ret_code (*Launch_Chunked)(struct scow_Kernel *self,
+            cl_command_queue *queue, const cl_uint num_chunks,
+            cl_uint evt_wait_list_size, const cl_event *evt_wait_list,
+            cl_event *chunk_evts, TIME_STUDY_MODE time_measure_mode);
+    /*!< Points on Kernel_Launch_Chunked(). */
+
+    ret_code (*Get_Chunk)(struct scow_Kernel *self, const cl_uint num_chunks,
+            const cl_uint chunk_index, size_t *offset, size_t *size);
+    /*!< Points on Kernel_Get_Chunk(). */
+
+    ret_code (*Flush_Args)(struct scow_Kernel *self);
+    /*!< Points on Kernel_Flush_Args(). */
+
     char* (*Get_Name)(struct scow_Kernel *self);
     /*!< Points on Kernel_ND_Range().
      * @warning The pointed function allocates memory for string. */
@@ -182,8 +279,8 @@ typedef struct scow_Kernel
  * @param[in] how_to_get_sources enumeration, that describes in what way
  * kernel source or pre-built program is provided
  * @param[in] source this argument can either be filename, if kernel source is
- * provided in file, or pre-built program goes in file, or it's a string with
- * source code
+ * provided in file (pre-built program is looked up in binary cache by that
+ * source), or it's a string with source code
  * @param[in] kernel_name name of OpenCL kernel
  * @param[in] extra_params extra parameters, that will be used during programm
  * building stage, if pre-built program isn't provided.
@@ -198,6 +295,53 @@ scow_Kernel* Make_Kernel(struct scow_Steel_Thread *parent_steel_thread,
         enum OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
         const char* kernel_name, const char* extra_params);
 
+/*!
+ * This function allocates memory for structure, sets function pointers &
+ * initializes OpenCL kernel from already built program.
+ *
+ * @param[in] parent_program program, which kernel is made from. Kernel holds
+ * reference to it until destroyed. If program is still being built, OpenCL
+ * kernel is created at first use.
+ * @param[in] kernel_name name of OpenCL kernel
+ * @param[in] given_kernel already created OpenCL kernel (e. g. by
+ * clCreateKernelsInProgram()), that will be owned by wrapper. This argument is
+ * optional - pass NULL to create kernel by name.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_KERNEL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Kernel* Make_Kernel_From_Program(scow_Program *parent_program,
+        const char* kernel_name, cl_kernel given_kernel);
+
+/*!
+ * This function allocates memory for structure, sets function pointers &
+ * initializes OpenCL kernel from program variant, specialized by compile-time
+ * constants. Identical variants are built once per Steel Thread.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * kernel source is provided
+ * @param[in] source this argument can either be filename, if kernel source is
+ * provided in file, or it's a string with source code
+ * @param[in] kernel_name name of OpenCL kernel
+ * @param[in] num_defines number of constants.
+ * @param[in] defines array of constants in form "NAME" or "NAME=VALUE".
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_KERNEL_PTR otherwise
+ *
+ * @see Make_Program_Variant()
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Kernel* Make_Kernel_Variant(struct scow_Steel_Thread *parent_steel_thread,
+        enum OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
+        const char* kernel_name, cl_uint num_defines, const char** defines);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,103 @@
+/*
+ * @file kernel_pool.h
+ * @brief Provides pool of kernel instances for multi-threaded launching
+ *
+ * @see kernel_pool.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_KERNEL_POOL_H_
+#define CL_KERNEL_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "kernel.h"
+
+/*! \def VOID_KERNEL_POOL_PTR
+ * Void pointer to Kernel Pool
+ */
+#undef VOID_KERNEL_POOL_PTR
+#define VOID_KERNEL_POOL_PTR    ((scow_Kernel_Pool*)0x0)
+
+/*! \struct scow_Kernel_Pool
+ *
+ *  This structure is pool of instances of single kernel. Each instance has its
+ *  own OpenCL kernel, arguments, ND sizes, events & timer, so Host threads,
+ *  which acquired different instances, may launch them simultaneously.
+ *
+ *  OpenCL kernels are cloned from prototype kernel via clCloneKernel(), if
+ *  Device supports OpenCL 2.1. They are created from program of prototype
+ *  kernel otherwise. Either way instance inherits ND sizes & arguments, bound
+ *  to prototype kernel. Instances are created at first acquisition & live
+ *  until pool is destroyed.
+ *
+ *  Acquisition & release are lock-free.
+ */
+typedef struct scow_Kernel_Pool
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    scow_Kernel* prototype;
+    /*!< Kernel, which instances are made from. It's not owned by pool. */
+
+    cl_uint max_instances;
+    /*!< Maximal number of instances. */
+
+    /*! \cond PRIVATE */
+    scow_Kernel** instances;
+    // Slot is acquired by some Host thread, accessed atomically only
+    cl_uint* in_use;
+    // Slot, which search for free instance is started from
+    cl_uint next_slot;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    scow_Kernel* (*Acquire)(struct scow_Kernel_Pool *self);
+    /*!< Points on Kernel_Pool_Acquire(). */
+
+    ret_code (*Release)(struct scow_Kernel_Pool *self, scow_Kernel *instance);
+    /*!< Points on Kernel_Pool_Release(). */
+
+    ret_code (*Destroy)(struct scow_Kernel_Pool *self);
+    /*!< Points on Kernel_Pool_Destroy(). */
+    /*!@}*/
+
+} scow_Kernel_Pool;
+
+/*!
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] prototype kernel, which instances are made from. Its ND sizes &
+ * arguments, bound by the moment of instance creation, are copied to each
+ * instance. It must outlive pool.
+ * @param[in] max_instances maximal number of instances, which may be acquired
+ * simultaneously. Usually it's number of Host threads.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_KERNEL_POOL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. All instances must be released before.
+ */
+scow_Kernel_Pool* Make_Kernel_Pool(scow_Kernel *prototype,
+        cl_uint max_instances);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_KERNEL_POOL_H_ */
@@ -59,6 +59,73 @@ typedef enum MEM_OBJECT_ETHALON
     DEVICE
 } MEM_OBJECT_ETHALON;
 
+/*! \def MEM_OBJECT_DIRTY_GAP
+ * Dirty ranges, which are closer than this number of bytes, are merged, as
+ * single transfer is cheaper than two small ones.
+ */
+#undef MEM_OBJECT_DIRTY_GAP
+#define MEM_OBJECT_DIRTY_GAP    (256)
+
+/*! \cond PRIVATE */
+// Range of bytes [begin, end), changed since the last Sync()
+typedef struct Dirty_Range
+{
+    size_t begin, end;
+} Dirty_Range;
+/*! \endcond */
+
+/*!
+ * \struct scow_Buffer_Rect
+ *
+ * This structure describes 2D or 3D rectangle, which is transferred between
+ * OpenCL buffer & Host memory or between two OpenCL buffers. X coordinates &
+ * width are given in bytes. Zero pitches mean tightly packed rectangle.
+ */
+typedef struct scow_Buffer_Rect
+{
+    size_t buffer_origin[3];
+    /*!< Origin of rectangle in buffer: byte, row & slice. */
+
+    size_t host_origin[3];
+    /*!< Origin of rectangle in Host memory or in destination buffer. */
+
+    size_t region[3];
+    /*!< Width in bytes, height in rows & depth in slices. For 2D rectangle
+     * depth is 1. */
+
+    size_t buffer_row_pitch, buffer_slice_pitch;
+    /*!< Row & slice pitches of buffer in bytes. */
+
+    size_t host_row_pitch, host_slice_pitch;
+    /*!< Row & slice pitches of Host memory or of destination buffer. */
+
+} scow_Buffer_Rect;
+
+/*!
+ * \struct scow_Image_Region
+ *
+ * This structure describes region of image, which is transferred between
+ * OpenCL image & Host memory or between two OpenCL images. Coordinates &
+ * sizes are given in pixels. For 1D image array the 2nd coordinate is index
+ * of image in array, for 2D image array the 3rd one is. Unused sizes are 1.
+ */
+typedef struct scow_Image_Region
+{
+    size_t origin[3];
+    /*!< Origin of region in image. */
+
+    size_t region[3];
+    /*!< Width, height & depth of region. */
+
+    size_t dest_origin[3];
+    /*!< Origin of region in destination image. Used only for copying. */
+
+    size_t row_pitch, slice_pitch;
+    /*!< Row & slice pitches of Host memory in bytes. Zero pitches mean tightly
+     * packed region. */
+
+} scow_Image_Region;
+
 /*!
  * \struct scow_Mem_Object
  *
@@ -72,6 +139,7 @@ typedef enum MEM_OBJECT_ETHALON
  *      - Map data
  *      - Unmap data
  *      - Copy data
+ *      - Fill data with pattern on Device side
  *      - Fast swap data without operations on Device side
  *
  * @example cl_mem_object_sample.c
@@ -102,6 +170,9 @@ typedef struct scow_Mem_Object
     cl_mem_flags mem_flags;
     /*!< Memory allocation flags. */
 
+    cl_mem_object_type image_type;
+    /*!< OpenCL image type. Applicable only for images. */
+
     cl_event unmap_evt;
     /*!< Internal event, that can be used for unmapping waiting. */
 
@@ -114,12 +185,23 @@ typedef struct scow_Mem_Object
     /*!< Image width. Applicable only for images. */
 
     height,
-    /*!< Image height. Applicable only for images. */
+    /*!< Image height, 1 for 1D images. Applicable only for images. */
+
+    depth,
+    /*!< Image depth, 1 unless image is 3D. Applicable only for images. */
+
+    array_size,
+    /*!< Number of images in image array, 1 for single image. Applicable only
+     * for images. */
 
     row_pitch,
     /*!< Image row pitch. Applicable only for images. This field is valid
      * only when image is mapped. */
 
+    slice_pitch,
+    /*!< Image slice pitch for 3D images & image arrays. This field is valid
+     * only when image is mapped. */
+
     origin;
     /*!< Start address of child memory object within bounds of parent
      *   memory object. For parent memory objects is always zero. */
@@ -131,6 +213,28 @@ typedef struct scow_Mem_Object
     *mapped_to_region;
     /*!< Pointer to mapped memory, if any mapping was made. */
 
+    size_t dirty_granularity;
+    /*!< Granularity of dirty ranges in bytes. Marked ranges are widened to
+     * its multiples, e.g. to page size for regions, changed via mapping.
+     * 0 means exact ranges. */
+
+    /*! \cond PRIVATE */
+    // OpenCL buffer is taken from pool of parent Steel Thread & may be larger
+    cl_bool is_pooled;
+
+    // Buffer is made over Host memory, allocated by Make_Buffer(), which is
+    // freed with OpenCL buffer. Transfers map it instead of copying.
+    cl_bool is_zero_copy;
+
+    // Sorted disjoint ranges, marked by Mark_Dirty() since the last Sync()
+    Dirty_Range *dirty;
+    cl_uint num_dirty, max_dirty;
+
+    // Error & Timer are embedded, 'error' & 'timer' point on them
+    scow_Error error_storage;
+    scow_Timer timer_storage;
+    /*! \endcond */
+
     /*! @name Fucntion pointers. */
     /**@{*/
     size_t (*Get_Width)(struct scow_Mem_Object *self);
@@ -170,12 +274,96 @@ typedef struct scow_Mem_Object
             cl_event* evt_to_generate, cl_command_queue explicit_queue);
     /*!< Points on Buffer_Copy() or Image_Copy(). */
 
+    /*! @name Partial transfers.
+     * Only given part of buffer is transferred. Applicable only for buffers. */
+    /**@{*/
+    void* (*Map_Range)(struct scow_Mem_Object *self, cl_bool blocking_map,
+            cl_map_flags map_flags, size_t offset, size_t size,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate,
+            cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Map_Range(). */
+
+    ret_code (*Write_Range)(struct scow_Mem_Object *self,
+            cl_bool blocking_flag, size_t offset, size_t size,
+            const void* source, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Write_Range(). */
+
+    ret_code (*Read_Range)(struct scow_Mem_Object *self,
+            cl_bool blocking_flag, size_t offset, size_t size,
+            void* destination, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Read_Range(). */
+
+    ret_code (*Copy_Range)(struct scow_Mem_Object *self,
+            struct scow_Mem_Object *dest, size_t src_offset,
+            size_t dst_offset, size_t size, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Copy_Range(). */
+
+    ret_code (*Write_Rect)(struct scow_Mem_Object *self,
+            cl_bool blocking_flag, const scow_Buffer_Rect *rect,
+            const void* source, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Write_Rect(). */
+
+    ret_code (*Read_Rect)(struct scow_Mem_Object *self,
+            cl_bool blocking_flag, const scow_Buffer_Rect *rect,
+            void* destination, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Read_Rect(). */
+
+    ret_code (*Copy_Rect)(struct scow_Mem_Object *self,
+            struct scow_Mem_Object *dest, const scow_Buffer_Rect *rect,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate,
+            cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Copy_Rect(). */
+    /**@}*/
+
+    /*! @name Region transfers.
+     * Only given region of image is transferred. Applicable only for images. */
+    /**@{*/
+    void* (*Map_Region)(struct scow_Mem_Object *self, cl_bool blocking_map,
+            cl_map_flags map_flags, const scow_Image_Region *region,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate,
+            cl_command_queue explicit_queue);
+    /*!< Points on Image_Map_Region(). */
+
+    ret_code (*Write_Region)(struct scow_Mem_Object *self,
+            cl_bool blocking_flag, const scow_Image_Region *region,
+            const void* source, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Image_Write_Region(). */
+
+    ret_code (*Read_Region)(struct scow_Mem_Object *self,
+            cl_bool blocking_flag, const scow_Image_Region *region,
+            void* destination, TIME_STUDY_MODE time_mode,
+            cl_event* evt_to_generate, cl_command_queue explicit_queue);
+    /*!< Points on Image_Read_Region(). */
+
+    ret_code (*Copy_Region)(struct scow_Mem_Object *self,
+            struct scow_Mem_Object *dest, const scow_Image_Region *region,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate,
+            cl_command_queue explicit_queue);
+    /*!< Points on Image_Copy_Region(). */
+    /**@}*/
+
     ret_code (*Swap)(struct scow_Mem_Object **self,
             struct scow_Mem_Object **dest);
     /*!< Points on Mem_Object_Swap(). */
 
+    ret_code (*Fill)(struct scow_Mem_Object *self, const void *pattern,
+            size_t pattern_size, size_t offset, size_t size,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate,
+            cl_command_queue explicit_queue);
+    /*!< Points on Buffer_Fill() or Image_Fill(). */
+
     ret_code (*Erase)(struct scow_Mem_Object* self);
-    /*!< Points on Buffer_Erase() of Image_Erase(). */
+    /*!< Points on Mem_Object_Erase(). */
+
+    ret_code (*Mark_Dirty)(struct scow_Mem_Object *self, size_t offset,
+            size_t size);
+    /*!< Points on Buffer_Mark_Dirty(). */
 
     ret_code(*Sync)(struct scow_Mem_Object* self, MEM_OBJECT_ETHALON ethalon,
         TIME_STUDY_MODE time_mode);
@@ -203,6 +391,10 @@ typedef struct scow_Mem_Object
  * @param[in] host_ptr pointer to Host-side memory region (if any). This argument
  * is optional. If not needed - provide null pointer instead.
  *
+ * If parent Steel Thread has buffer pool & no Host pointer is given, OpenCL
+ * buffer is taken from pool & returned to it at destruction. Its content is
+ * undefined then, as well as content of newly created buffer.
+ *
  * @return pointer to allocated structure in case of success,
  * \ref VOID_MEM_OBJ_PTR otherwise
  *
@@ -241,6 +433,54 @@ scow_Mem_Object* Make_Image(
     const size_t                row_pitch,
     void                        *host_ptr);
 
+/*!
+ * This function allocates memory for Memory Object with OpenCL image of any
+ * type - 1D, 2D, 3D, 1D or 2D image array, or image over buffer - & sets
+ * function pointers.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives OpenCL context, etc
+ * @param[in] mem_flags OpenCL memory flags, which will be used for OpenCL
+ * memory objects creation
+ * @param[in] image_format OpenCL image format, that describe characteristics
+ * @param[in] image_desc OpenCL image description: type, sizes & pitches.
+ * @param[in] host_ptr pointer to Host-side memory region (if any). This argument
+ * is optional. If not needed - provide null pointer instead.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated
+ * by this function.
+ */
+scow_Mem_Object* Make_Image_From_Desc(
+    struct scow_Steel_Thread    *parent_thread,
+    const cl_mem_flags          mem_flags,
+    const cl_image_format       *image_format,
+    const cl_image_desc         *image_desc,
+    void                        *host_ptr);
+
+/*!
+ * This function allocates memory for Memory Object with 1D OpenCL image, which
+ * aliases given Buffer, & sets function pointers. No data is copied: kernels
+ * get texture access to linear data of Buffer.
+ *
+ * @param[in] buffer Buffer, which holds image data. It must outlive image.
+ * @param[in] mem_flags OpenCL memory flags. Zero takes flags of Buffer.
+ * @param[in] image_format OpenCL image format, that describe characteristics
+ * @param[in] width image width in pixels. Buffer must hold that many pixels.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated
+ * by this function.
+ */
+scow_Mem_Object* Make_Image_From_Buffer(
+    scow_Mem_Object             *buffer,
+    const cl_mem_flags          mem_flags,
+    const cl_image_format       *image_format,
+    const size_t                width);
+
 #ifdef __cplusplus
 }
 #endif
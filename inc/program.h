@@ -0,0 +1,222 @@
+/*
+ * @file program.h
+ * @brief Provides basic abstraction for OpenCL program, shared by kernels
+ *
+ * @see program.c
+ * @see kernel.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_PROGRAM_H_
+#define CL_PROGRAM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <pthread.h>
+
+#include "error.h"
+
+/*! \def VOID_PROGRAM_PTR
+ * Void pointer to Program
+ */
+#undef VOID_PROGRAM_PTR
+#define VOID_PROGRAM_PTR    ((scow_Program*)0x0)
+
+typedef enum OPENCL_SOURCES_MODE
+{
+    /*! Read kernel source from files. */
+    READ_FROM_FILES = 0,
+
+    /*! Read kernel source from string. */
+    READ_FROM_STRING,
+
+    /*! Read kernel source from file, but load pre-built OpenCL program from
+     * on-disk binary cache of parent Steel Thread, if it's there. Program is
+     * built from source & stored into cache otherwise. */
+    READ_FROM_BINARY,
+
+    /*! Load SPIR-V module, so that OpenCL C compilation is skipped. Source is
+     * name of program, embedded into library at build time (name of .cl file
+     * without extension), or path to SPIR-V file. If Device doesn't support
+     * IL, embedded program is built from its OpenCL C source. */
+    READ_FROM_IL
+} OPENCL_SOURCES_MODE;
+
+struct scow_Kernel;
+struct scow_Steel_Thread;
+
+/*! \struct scow_Program
+ *
+ *  This structure is wrapper for cl_program provided by OpenCL API. Program
+ *  is built once & any number of kernels can be made from it. Program is
+ *  reference counted: every kernel made from it holds one reference, so
+ *  program is released only when its creator & all its kernels are destroyed.
+ *
+ *  All programs are registered in parent Steel Thread, which releases the
+ *  ones left at its own destruction.
+ *
+ *  Program made by Make_Program_Async() is built by worker threads of parent
+ *  Steel Thread & acts as future: kernels can be made from it right away, but
+ *  OpenCL kernel is created only at first use, which waits for build to finish.
+ *
+ *  Program made by Make_Program_Variant() is specialization of source by set
+ *  of compile-time constants. Identical variants are built once per Steel
+ *  Thread & shared by all their users.
+ */
+typedef struct scow_Program
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    cl_program program;
+    /*!< OpenCL program. */
+
+    cl_uint ref_count;
+    /*!< Number of owners - creator & kernels, made from program. It's changed
+     * atomically, so kernels may be made & destroyed by different threads. */
+
+    cl_uint num_kernels;
+    /*!< Number of kernels, made from program & not destroyed yet. It's
+     * changed atomically like 'ref_count'. */
+
+    struct scow_Steel_Thread* parent_steel_thread;
+    /*!< Parent OpenCL Steel Thread which gives context, Device, etc. */
+
+    struct scow_Program* next;
+    /*!< Next program in list of parent Steel Thread. */
+
+    cl_build_status build_status;
+    /*!< CL_BUILD_IN_PROGRESS while program is built, CL_BUILD_SUCCESS or
+     * CL_BUILD_ERROR after that. Use 'Get_Build_Status' to read it. */
+
+    ret_code build_ret;
+    /*!< Result of build. Valid only when build is finished. */
+
+    cl_ulong variant_key;
+    /*!< Key of source & sorted defines for programs, made by
+     * Make_Program_Variant(), 0 for others. */
+
+    /*! \cond PRIVATE */
+    pthread_mutex_t build_lock;
+    pthread_cond_t build_done;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    struct scow_Kernel* (*Get_Kernel)(struct scow_Program *self,
+            const char *kernel_name);
+    /*!< Points on Program_Get_Kernel(). */
+
+    struct scow_Kernel** (*Get_All_Kernels)(struct scow_Program *self,
+            cl_uint *num_kernels);
+    /*!< Points on Program_Get_All_Kernels().
+     * @warning The pointed function allocates memory for array. */
+
+    ret_code (*Wait_Build)(struct scow_Program *self);
+    /*!< Points on Program_Wait_Build(). */
+
+    cl_build_status (*Get_Build_Status)(struct scow_Program *self);
+    /*!< Points on Program_Get_Build_Status(). */
+
+    struct scow_Program* (*Retain)(struct scow_Program *self);
+    /*!< Points on Program_Retain(). */
+
+    ret_code (*Destroy)(struct scow_Program *self);
+    /*!< Points on Program_Destroy(). */
+    /*!@}*/
+
+} scow_Program;
+
+/*!
+ * This function allocates memory for structure, sets function pointers,
+ * creates & builds OpenCL program.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * program source is provided
+ * @param[in] source this argument can either be filename, if program source is
+ * provided in file (pre-built program is looked up in binary cache by that
+ * source), or it's a string with source code
+ * @param[in] extra_params extra parameters, that will be used during programm
+ * building stage. This argument is optional, pass NULL if not needed.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_PROGRAM_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to release reference,
+ * obtained from this function.
+ */
+scow_Program* Make_Program(struct scow_Steel_Thread *parent_steel_thread,
+        enum OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
+        const char* extra_params);
+
+/*!
+ * This function allocates memory for structure, sets function pointers &
+ * submits OpenCL program build to worker threads of parent Steel Thread.
+ * It returns without waiting for build to finish, so that many programs can
+ * be built in parallel.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * program source is provided
+ * @param[in] source this argument can either be filename, if program source is
+ * provided in file (pre-built program is looked up in binary cache by that
+ * source), or it's a string with source code. String is copied, so it may be
+ * freed right after call.
+ * @param[in] extra_params extra parameters, that will be used during programm
+ * building stage. This argument is optional, pass NULL if not needed.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_PROGRAM_PTR otherwise. Use 'Wait_Build' function pointer to get
+ * result of build.
+ *
+ * @warning always use 'Destroy' function pointer to release reference,
+ * obtained from this function.
+ */
+scow_Program* Make_Program_Async(struct scow_Steel_Thread *parent_steel_thread,
+        enum OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
+        const char* extra_params);
+
+/*!
+ * This function returns program, which is built from given source with given
+ * constants defined. If such variant was already made under parent Steel
+ * Thread & is still alive, it's shared instead of building new one.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * program source is provided. With READ_FROM_BINARY variant is looked up in
+ * on-disk binary cache as well, if it isn't made in this process yet.
+ * @param[in] source this argument can either be filename, if program source is
+ * provided in file, or it's a string with source code
+ * @param[in] num_defines number of constants.
+ * @param[in] defines array of constants in form "NAME" or "NAME=VALUE". Order
+ * doesn't matter, each constant is passed to compiler as -D option.
+ *
+ * @return pointer to allocated or shared structure in case of success,
+ * \ref VOID_PROGRAM_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to release reference,
+ * obtained from this function.
+ */
+scow_Program* Make_Program_Variant(
+        struct scow_Steel_Thread *parent_steel_thread,
+        enum OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
+        cl_uint num_defines, const char** defines);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_PROGRAM_H_ */
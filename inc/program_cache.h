@@ -0,0 +1,151 @@
+/*
+ * @file program_cache.h
+ * @brief Persistent on-disk cache of built OpenCL program binaries
+ *
+ * @see program_cache.c
+ * @see kernel.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_PROGRAM_CACHE_H_
+#define CL_PROGRAM_CACHE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "typedefs.h"
+
+/*! \def SCOW_DEFAULT_BINARY_CACHE_DIR
+ * Directory, where program binaries are stored unless Steel Thread is given
+ * another one.
+ */
+#undef SCOW_DEFAULT_BINARY_CACHE_DIR
+#define SCOW_DEFAULT_BINARY_CACHE_DIR   "."
+
+/*! \def SCOW_TUNING_DB_FILE_NAME
+ * Name of file in binary cache directory, where tuned kernel parameters are
+ * stored.
+ */
+#undef SCOW_TUNING_DB_FILE_NAME
+#define SCOW_TUNING_DB_FILE_NAME        "scow_tuning.db"
+
+struct scow_Steel_Thread;
+
+/**
+ * @brief This function computes key of program, which is built from given
+ * source with given options. Key is the same for every Device, so it
+ * identifies program within single Steel Thread only.
+ *
+ * @param[in] source OpenCL C source code of program.
+ * @param[in] build_params options, that program is built with.
+ *
+ * @return 64-bit hash of source & options, never 0.
+ */
+cl_ulong Get_Program_Key(
+    const char                  *source,
+    const char                  *build_params);
+
+/**
+ * @brief This function looks up program binary in the on-disk cache of given
+ * Steel Thread, creates OpenCL program from it & builds it.
+ *
+ * Binary is found by key, which consists of program source, build options,
+ * Device name & driver version. So any change of them leads to cache miss.
+ *
+ * @param[in] steel_thread Steel Thread, which gives context, Device & cache
+ * directory.
+ * @param[in] source OpenCL C source code of program.
+ * @param[in] build_params options, that program is built with.
+ * @param[out] ret operation return code.
+ *
+ * @return built OpenCL program in case of cache hit, NULL otherwise. Stale or
+ * rejected by runtime binaries are reported as cache miss, so caller may fall
+ * back to build from source.
+ */
+cl_program Load_Program_Binary(
+    struct scow_Steel_Thread    *steel_thread,
+    const char                  *source,
+    const char                  *build_params,
+    ret_code                    *ret);
+
+/**
+ * @brief This function stores binary of built OpenCL program in the on-disk
+ * cache of given Steel Thread. Binary is written to temporary file at first
+ * & renamed then, so concurrent processes never see partially written file.
+ *
+ * @param[in] steel_thread Steel Thread, which gives Device & cache directory.
+ * @param[in] program successfully built OpenCL program.
+ * @param[in] source OpenCL C source code of program.
+ * @param[in] build_params options, that program was built with.
+ *
+ * @return \ref CL_SUCCESS in case of success, error code of type ret_code
+ * otherwise.
+ */
+ret_code Store_Program_Binary(
+    struct scow_Steel_Thread    *steel_thread,
+    cl_program                  program,
+    const char                  *source,
+    const char                  *build_params);
+
+/**
+ * @brief This function looks up local work group size, tuned for given kernel,
+ * in tuning database of given Steel Thread.
+ *
+ * Entry is found by Device name, driver version, kernel name, dimensionality &
+ * global size class. Global size class is power of two, which is not less than
+ * global size in each dimension. If there are several entries with same key,
+ * the last one is used.
+ *
+ * @param[in] steel_thread Steel Thread, which gives Device & cache directory.
+ * @param[in] kernel_name name of OpenCL kernel.
+ * @param[in] dimensionality number of problem's dimensions.
+ * @param[in] global_size global amount of work items in each dimension.
+ * @param[out] local_size tuned local work group size in each dimension. Zero
+ * sizes mean, that local work group size is left to OpenCL runtime.
+ *
+ * @return \ref CL_SUCCESS in case of success, \ref ARG_NOT_FOUND if there is no
+ * entry, error code of type ret_code otherwise.
+ */
+ret_code Load_Tuned_Local_Size(
+    struct scow_Steel_Thread    *steel_thread,
+    const char                  *kernel_name,
+    cl_uint                     dimensionality,
+    const size_t                *global_size,
+    size_t                      *local_size);
+
+/**
+ * @brief This function appends local work group size, tuned for given kernel,
+ * to tuning database of given Steel Thread.
+ *
+ * @param[in] steel_thread Steel Thread, which gives Device & cache directory.
+ * @param[in] kernel_name name of OpenCL kernel.
+ * @param[in] dimensionality number of problem's dimensions.
+ * @param[in] global_size global amount of work items in each dimension.
+ * @param[in] local_size tuned local work group size in each dimension.
+ *
+ * @return \ref CL_SUCCESS in case of success, error code of type ret_code
+ * otherwise.
+ */
+ret_code Store_Tuned_Local_Size(
+    struct scow_Steel_Thread    *steel_thread,
+    const char                  *kernel_name,
+    cl_uint                     dimensionality,
+    const size_t                *global_size,
+    const size_t                *local_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_PROGRAM_CACHE_H_ */
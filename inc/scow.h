@@ -17,15 +17,27 @@
 
 #pragma once
 
+#include "arena.h"
+#include "buffer_pool.h"
 #include "device.h"
 #include "devices.h"
+#include "embedded_il.h"
 #include "err_codes.h"
 #include "error.h"
+#include "file_buffer.h"
+#include "graph.h"
 #include "kernel.h"
+#include "kernel_pool.h"
 #include "mem_object.h"
 #include "platform.h"
 #include "platforms.h"
+#include "program.h"
+#include "program_cache.h"
 #include "setup_teardown.h"
+#include "slab.h"
+#include "staging_ring.h"
 #include "steel_thread.h"
+#include "stream_pipeline.h"
+#include "thread_pool.h"
 #include "timer.h"
 #include "typedefs.h"
@@ -0,0 +1,105 @@
+/*
+ * @file slab.h
+ * @brief Provides allocator of fixed-size objects, carved out of large chunks
+ *
+ * @see slab.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_SLAB_H_
+#define CL_SLAB_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <pthread.h>
+
+#include "typedefs.h"
+
+/*! \def VOID_SLAB_PTR
+ * Void pointer to Slab
+ */
+#undef VOID_SLAB_PTR
+#define VOID_SLAB_PTR           ((scow_Slab*)0x0)
+
+/*! \def SLAB_ALIGNMENT
+ * Alignment of objects in bytes. It suits any type, used by library.
+ */
+#undef SLAB_ALIGNMENT
+#define SLAB_ALIGNMENT          (16)
+
+/*! \def SLAB_OBJECTS_PER_CHUNK
+ * Default number of objects, which are allocated by single malloc.
+ */
+#undef SLAB_OBJECTS_PER_CHUNK
+#define SLAB_OBJECTS_PER_CHUNK  (64)
+
+/*! \struct scow_Slab
+ *
+ *  This structure allocates objects of the same size. Objects are carved out
+ *  of chunks, which are allocated by single malloc each, & freed objects are
+ *  kept in free list for reuse. Chunks are freed only at destruction.
+ *
+ *  Slab is thread-safe.
+ */
+typedef struct scow_Slab
+{
+    size_t object_size;
+    /*!< Size of object in bytes, rounded up to \ref SLAB_ALIGNMENT. */
+
+    cl_uint objects_per_chunk;
+    /*!< Number of objects in chunk. */
+
+    cl_ulong num_chunks, num_live;
+    /*!< Number of allocated chunks & objects in use. */
+
+    /*! \cond PRIVATE */
+    pthread_mutex_t lock;
+    void *chunks, *free_list;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    void* (*Alloc)(struct scow_Slab *self);
+    /*!< Points on Slab_Alloc(). */
+
+    ret_code (*Free)(struct scow_Slab *self, void *object);
+    /*!< Points on Slab_Free(). */
+
+    ret_code (*Destroy)(struct scow_Slab *self);
+    /*!< Points on Slab_Destroy(). */
+    /*!@}*/
+
+} scow_Slab;
+
+/*!
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] object_size size of object in bytes.
+ * @param[in] objects_per_chunk number of objects, allocated at once. Zero
+ * takes \ref SLAB_OBJECTS_PER_CHUNK.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_SLAB_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. All objects must be freed before.
+ */
+scow_Slab* Make_Slab(size_t object_size, cl_uint objects_per_chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_SLAB_H_ */
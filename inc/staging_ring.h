@@ -0,0 +1,119 @@
+/*
+ * @file staging_ring.h
+ * @brief Provides ring of pinned Host-side staging buffers
+ *
+ * @see staging_ring.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_STAGING_RING_H_
+#define CL_STAGING_RING_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "mem_object.h"
+
+/*! \def VOID_STAGING_RING_PTR
+ * Void pointer to Staging Ring
+ */
+#undef VOID_STAGING_RING_PTR
+#define VOID_STAGING_RING_PTR   ((scow_Staging_Ring*)0x0)
+
+/*! \cond PRIVATE */
+// Persistently mapped buffer & the last transfer, which uses it
+typedef struct Staging_Slot
+{
+    scow_Mem_Object *buffer;
+    void *host_ptr;
+    cl_event fence;
+} Staging_Slot;
+/*! \endcond */
+
+/*! \struct scow_Staging_Ring
+ *
+ *  This structure hands out Host memory, which is backed by buffers, created
+ *  with CL_MEM_ALLOC_HOST_PTR & mapped for whole lifetime of ring. Such memory
+ *  is pinned, so transfers from & to it avoid extra copy into bounce buffer,
+ *  which is done by runtime for pageable memory.
+ *
+ *  Slots are handed out in round-robin order. Slot is reused only after the
+ *  last transfer, which uses it, is complete, so ring of few slots serves
+ *  stream of frames without any allocation.
+ */
+typedef struct scow_Staging_Ring
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    struct scow_Steel_Thread* parent_thread;
+    /*!< Parent Steel Thread, which gives context & queues. */
+
+    cl_uint num_slots;
+    /*!< Number of slots in ring. */
+
+    size_t slot_size;
+    /*!< Size of each slot in bytes. */
+
+    /*! \cond PRIVATE */
+    Staging_Slot* slots;
+    cl_uint next_slot;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    void* (*Acquire)(struct scow_Staging_Ring *self);
+    /*!< Points on Staging_Ring_Acquire(). */
+
+    ret_code (*Upload)(struct scow_Staging_Ring *self, const void *host_ptr,
+            scow_Mem_Object *dest, size_t offset, size_t size,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate);
+    /*!< Points on Staging_Ring_Upload(). */
+
+    ret_code (*Download)(struct scow_Staging_Ring *self, void *host_ptr,
+            scow_Mem_Object *src, size_t offset, size_t size,
+            TIME_STUDY_MODE time_mode, cl_event* evt_to_generate);
+    /*!< Points on Staging_Ring_Download(). */
+
+    ret_code (*Wait)(struct scow_Staging_Ring *self, const void *host_ptr);
+    /*!< Points on Staging_Ring_Wait(). */
+
+    ret_code (*Destroy)(struct scow_Staging_Ring *self);
+    /*!< Points on Staging_Ring_Destroy(). */
+    /*!@}*/
+
+} scow_Staging_Ring;
+
+/*!
+ * This function allocates memory for structure, creates & maps buffer for
+ * each slot & sets function pointers.
+ *
+ * @param[in] thread pointer to Steel Thread, which gives context & queues.
+ * @param[in] num_slots number of slots in ring.
+ * @param[in] slot_size size of each slot in bytes.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_STAGING_RING_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Staging_Ring* Make_Staging_Ring(struct scow_Steel_Thread *thread,
+        cl_uint num_slots, size_t slot_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_STAGING_RING_H_ */
@@ -23,6 +23,8 @@ extern "C"
 {
 #endif
 
+#include <pthread.h>
+
 #include "typedefs.h"
 
 /*! \def CL_BUILD_PARAMS_STRING_SIZE
@@ -43,9 +45,13 @@ extern "C"
 #undef VOID_STEEL_THREAD_PTR
 #define VOID_STEEL_THREAD_PTR       ((scow_Steel_Thread*)0x0)
 
+struct scow_Buffer_Pool;
 struct scow_Error;
 struct scow_Device;
 struct scow_Platform;
+struct scow_Program;
+struct scow_Slab;
+struct scow_Thread_Pool;
 
 /*! \struct scow_Steel_Thread
  *
@@ -83,9 +89,40 @@ typedef struct scow_Steel_Thread
     /*!< Additional built parameters, that will be passed at OpenCL program build
      * stage*/
 
+    char binary_cache_dir[CL_KERNEL_FILE_NAME_SIZE];
+    /*!< Directory, where built OpenCL program binaries are cached. */
+
     cl_context context;
     /*!< OpenCL context. */
 
+    struct scow_Program* programs;
+    /*!< List of OpenCL programs, built under this Steel Thread. */
+
+    /*! \cond PRIVATE */
+    // Guards list of programs, which is shared by Host threads
+    pthread_mutex_t programs_lock;
+    /*! \endcond */
+
+    struct scow_Thread_Pool* build_pool;
+    /*!< Worker threads, which build programs made by Make_Program_Async().
+     * Started at first asynchronous build. */
+
+    struct scow_Buffer_Pool* buffer_pool;
+    /*!< Free OpenCL buffers, which are reused by Make_Buffer(). NULL, unless
+     * Enable_Buffer_Pool() is called. */
+
+    cl_bool zero_copy;
+    /*!< CL_TRUE if Device shares memory with Host (CPU Device or Host unified
+     * memory). Then buffers, made without Host pointer, live in aligned Host
+     * memory & transfers map them instead of copying. It's detected at
+     * creation & may be reset before buffers are made. */
+
+    struct scow_Slab *mem_object_slab,
+    /*!< Memory for Memory Objects, made under this Steel Thread. */
+
+    *kernel_slab;
+    /*!< Memory for kernels, made under this Steel Thread. */
+
     /*! @name Command queues.
      * These are command queues, that are used most often - for Host-Device
      * intercommunication & kernel execution. */
@@ -106,7 +143,8 @@ typedef struct scow_Steel_Thread
     /*! @name Function pointers. */
     /*!@{*/
     ret_code (*Destroy)(struct scow_Steel_Thread *self);
-    /*!< Points on Steel_Thread_Destroy(). */
+    /*!< Points on Steel_Thread_Destroy(). Memory Objects & kernels
+     * should be destroyed before. */
 
     ret_code (*Wait_For_Commands)(struct scow_Steel_Thread *self);
     /*!< Points on Steel_Thread_Wait_For_Commands(). */
@@ -116,6 +154,14 @@ typedef struct scow_Steel_Thread
 
     ret_code(*FlushCmd)(struct scow_Steel_Thread* self);
     /*!< Points on Steel_Thread_Flush_Cmd()*/
+
+    ret_code (*Set_Binary_Cache_Dir)(struct scow_Steel_Thread *self,
+            const char *dir);
+    /*!< Points on Steel_Thread_Set_Binary_Cache_Dir(). */
+
+    ret_code (*Enable_Buffer_Pool)(struct scow_Steel_Thread *self,
+            size_t budget);
+    /*!< Points on Steel_Thread_Enable_Buffer_Pool(). */
 /*!@}*/
 
 } scow_Steel_Thread;
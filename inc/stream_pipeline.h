@@ -0,0 +1,132 @@
+/*
+ * @file stream_pipeline.h
+ * @brief Provides streaming of data through kernel with overlapped transfers
+ *
+ * @see stream_pipeline.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_STREAM_PIPELINE_H_
+#define CL_STREAM_PIPELINE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "mem_object.h"
+
+/*! \def VOID_STREAM_PIPELINE_PTR
+ * Void pointer to Stream Pipeline
+ */
+#undef VOID_STREAM_PIPELINE_PTR
+#define VOID_STREAM_PIPELINE_PTR    ((scow_Stream_Pipeline*)0x0)
+
+/*! Fills next chunk of input in Host memory. Returns size of chunk in bytes,
+ * which is at most 'max_size', or 0 at the end of input. */
+typedef size_t (*Stream_Source)(void *user_data, cl_uint chunk_index,
+        void *chunk, size_t max_size);
+
+/*! Prepares kernel for chunk: sets ND sizes & arguments besides the first two,
+ * which are input & output buffers. */
+typedef ret_code (*Stream_Prepare)(void *user_data, scow_Kernel *kernel,
+        cl_uint chunk_index, size_t size);
+
+/*! Consumes chunk of output in Host memory. Chunks come in input order. */
+typedef ret_code (*Stream_Sink)(void *user_data, cl_uint chunk_index,
+        const void *chunk, size_t size);
+
+/*! \cond PRIVATE */
+// Buffers of one chunk in flight
+typedef struct Stream_Slot
+{
+    scow_Mem_Object *input, *output;
+    void *host_input, *host_output;
+    // Download of chunk is done, NULL if slot is free
+    cl_event read_done;
+    cl_uint chunk_index;
+    size_t output_size;
+} Stream_Slot;
+/*! \endcond */
+
+/*! \struct scow_Stream_Pipeline
+ *
+ *  This structure streams input through kernel chunk by chunk. Each chunk is
+ *  uploaded via Host to Device queue, processed via command queue &
+ *  downloaded via Device to Host queue of parent Steel Thread. Stages are
+ *  chained with events, so that upload of next chunk, processing of current
+ *  one & download of previous one are overlapped.
+ *
+ *  Input buffer of chunk is bound as the 1st kernel argument, output buffer
+ *  is bound as the 2nd one.
+ */
+typedef struct scow_Stream_Pipeline
+{
+    scow_Error* error;
+    /*!< Structure for errors handling. */
+
+    struct scow_Steel_Thread* parent_thread;
+    /*!< Parent Steel Thread, which gives queues. */
+
+    scow_Kernel* kernel;
+    /*!< Kernel, which processes chunks. */
+
+    cl_uint depth;
+    /*!< Maximal number of chunks in flight. */
+
+    size_t input_chunk_size, output_chunk_size;
+    /*!< Sizes of full input & output chunks in bytes. Output of partial chunk
+     * is proportional to its input. */
+
+    cl_uint num_chunks;
+    /*!< Number of chunks, processed by last Run(). */
+
+    /*! \cond PRIVATE */
+    Stream_Slot* slots;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    ret_code (*Run)(struct scow_Stream_Pipeline *self, Stream_Source source,
+            Stream_Prepare prepare, Stream_Sink sink, void *user_data);
+    /*!< Points on Stream_Pipeline_Run(). */
+
+    ret_code (*Destroy)(struct scow_Stream_Pipeline *self);
+    /*!< Points on Stream_Pipeline_Destroy(). */
+    /*!@}*/
+
+} scow_Stream_Pipeline;
+
+/*!
+ * This function allocates memory for structure, Device & Host buffers for
+ * each chunk in flight & sets function pointers.
+ *
+ * @param[in] kernel kernel, which processes chunks. It must outlive pipeline.
+ * @param[in] depth maximal number of chunks in flight. 3 is enough to overlap
+ * all stages.
+ * @param[in] input_chunk_size size of full input chunk in bytes.
+ * @param[in] output_chunk_size size of full output chunk in bytes.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_STREAM_PIPELINE_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Stream_Pipeline* Make_Stream_Pipeline(scow_Kernel *kernel, cl_uint depth,
+        size_t input_chunk_size, size_t output_chunk_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_STREAM_PIPELINE_H_ */
@@ -0,0 +1,100 @@
+/*
+ * @file thread_pool.h
+ * @brief Provides simple pool of Host worker threads
+ *
+ * @see thread_pool.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef CL_THREAD_POOL_H_
+#define CL_THREAD_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <pthread.h>
+
+#include "error.h"
+
+/*! \def VOID_THREAD_POOL_PTR
+ * Void pointer to Thread Pool
+ */
+#undef VOID_THREAD_POOL_PTR
+#define VOID_THREAD_POOL_PTR    ((scow_Thread_Pool*)0x0)
+
+/*! Job, that is executed by one of the pool workers. */
+typedef void (*Thread_Pool_Job)(void *job_arg);
+
+/*! \cond PRIVATE */
+typedef struct Thread_Pool_Task
+{
+    Thread_Pool_Job job;
+    void *job_arg;
+    struct Thread_Pool_Task *next;
+} Thread_Pool_Task;
+/*! \endcond */
+
+/*! \struct scow_Thread_Pool
+ *
+ *  This structure is pool of Host threads, which execute submitted jobs in
+ *  FIFO order. It's used for work, that can be done in parallel on Host, such
+ *  as OpenCL programs building.
+ */
+typedef struct scow_Thread_Pool
+{
+    pthread_t *workers;
+    /*!< Worker threads. */
+
+    size_t num_workers;
+    /*!< Number of worker threads. */
+
+    /*! \cond PRIVATE */
+    pthread_mutex_t lock;
+    pthread_cond_t has_tasks;
+    Thread_Pool_Task *head, *tail;
+    cl_bool shutdown;
+    /*! \endcond */
+
+    /*! @name Function pointers. */
+    /*!@{*/
+    ret_code (*Submit)(struct scow_Thread_Pool *self, Thread_Pool_Job job,
+            void *job_arg);
+    /*!< Points on Thread_Pool_Submit(). */
+
+    ret_code (*Destroy)(struct scow_Thread_Pool *self);
+    /*!< Points on Thread_Pool_Destroy(). */
+    /*!@}*/
+
+} scow_Thread_Pool;
+
+/*!
+ * This function allocates memory for structure, sets function pointers &
+ * starts worker threads.
+ *
+ * @param[in] num_workers number of worker threads. Pass 0 to start one worker
+ * per online Host CPU core.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_THREAD_POOL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. It finishes all submitted jobs before return.
+ */
+scow_Thread_Pool* Make_Thread_Pool(size_t num_workers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CL_THREAD_POOL_H_ */
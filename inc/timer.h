@@ -25,6 +25,7 @@ extern "C"
 
 #include "error.h"
 #include <time.h>
+#include <pthread.h>
 
 struct scow_Kernel;
 
@@ -45,8 +46,13 @@ typedef enum TIME_STUDY_MODE
     MEASURE = 0,
     /*!< Only obtain time measurement result for current operation. */
 
-    DONT_MEASURE
-/*!< Don't measure time. */
+    DONT_MEASURE,
+    /*!< Don't measure time. */
+
+    MEASURE_ASYNC
+/*!< Obtain time measurement result, when operation is complete, without
+ * waiting for it. Results are folded into Timer from OpenCL runtime thread, so
+ * use 'Wait_Pending' before reading them, if all of them are needed. */
 } TIME_STUDY_MODE;
 
 typedef enum TIME_SIDE
@@ -105,6 +111,16 @@ typedef struct scow_Timer
     struct scow_Kernel* parent_kernel;
     /*!< Parent OpenCL kernel if any (Timer may not have parent kernel). */
 
+    cl_uint num_pending;
+    /*!< Number of operations, measured in \ref MEASURE_ASYNC mode, which are
+     * not complete yet. */
+
+    /*! \cond PRIVATE */
+    // Guards Device counters, which are updated from OpenCL runtime thread
+    pthread_mutex_t lock;
+    pthread_cond_t pending_done;
+    /*! \endcond */
+
     /*! @name Function pointers.*/
     /*!@{*/
     ret_code (*Destroy)(struct scow_Timer *self);
@@ -119,6 +135,13 @@ typedef struct scow_Timer
     ret_code (*Reset)(struct scow_Timer *self, TIME_SIDE what_time);
     /*!< Points on Timer_Reset(). */
 
+    ret_code (*Measure_Event)(struct scow_Timer *self, cl_event *event,
+            TIME_STUDY_MODE time_mode);
+    /*!< Points on Timer_Measure_Event(). */
+
+    ret_code (*Wait_Pending)(struct scow_Timer *self);
+    /*!< Points on Timer_Wait_Pending(). */
+
     double (*Get_Total_Time)(struct scow_Timer *self, TIME_SIDE what_time);
     /*!< Points on Timer_Get_Total_Time(). */
 
@@ -148,6 +171,34 @@ typedef struct scow_Timer
  */
 scow_Timer* Make_Timer(struct scow_Kernel *parent_kernel);
 
+/*!
+ * This function initializes Timer, which is embedded into another structure,
+ * & sets function pointers.
+ *
+ * @param[out] self pointer to zero-filled structure to initialize.
+ * @param[in] parent_kernel pointer to Minimal Kernel. This argument is
+ * optional - if you don't need to measure kernel time, provide void pointer as
+ * argument.
+ *
+ * @return pointer to initialized structure in case of success,
+ * \ref VOID_TIME_STUDY_PTR otherwise
+ *
+ * @warning 'Destroy' function pointer doesn't free memory of structure, it's
+ * freed together with structure, which it's embedded into.
+ */
+scow_Timer* Init_Timer(scow_Timer* self, struct scow_Kernel *parent_kernel);
+
+/*!
+ * This function waits for OpenCL event & gathers execution time of command,
+ * associated with it. Command must be enqueued into queue with profiling
+ * enabled.
+ *
+ * @param[in] event pointer to OpenCL event.
+ *
+ * @return execution time in microseconds in case of success, -1.0 otherwise.
+ */
+cl_double Gather_Time_uS(cl_event *event);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,331 @@
+/*
+ * @file arena.c
+ * @brief Provides sub-allocation of aligned sub-buffers from one OpenCL buffer
+ *
+ * @see arena.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+
+#include "arena.h"
+#include "steel_thread.h"
+#include "device.h"
+
+/*! \cond PRIVATE */
+static size_t Align_Up(scow_Arena *self, size_t size)
+{
+    return (size + self->alignment - 1) / self->alignment * self->alignment;
+}
+
+// Takes range from the first free block, which fits, or from top of arena
+static cl_bool Take_Range(scow_Arena *self, size_t size, size_t *origin)
+{
+    for (Arena_Block **curr = &self->free_blocks; *curr;
+            curr = &(*curr)->next)
+    {
+        Arena_Block *block = *curr;
+
+        if (block->size < size)
+        {
+            continue;
+        }
+
+        *origin = block->origin;
+        block->origin += size;
+        block->size -= size;
+
+        if (!block->size)
+        {
+            *curr = block->next;
+            free(block);
+        }
+
+        return CL_TRUE;
+    }
+
+    if (self->buffer->size - self->top < size)
+    {
+        return CL_FALSE;
+    }
+
+    *origin = self->top;
+    self->top += size;
+
+    return CL_TRUE;
+}
+
+/* Gives range back. Free blocks are kept sorted by origin & merged with
+ * neighbours, so the last block is the only one, which may touch top. */
+static ret_code Give_Range(scow_Arena *self, size_t origin, size_t size)
+{
+    Arena_Block **curr = &self->free_blocks, **prev_link = NULL, *prev = NULL;
+
+    while (*curr && (*curr)->origin < origin)
+    {
+        prev_link = curr;
+        prev = *curr;
+        curr = &(*curr)->next;
+    }
+
+    if (origin + size == self->top)
+    {
+        self->top = origin;
+
+        if (prev && prev->origin + prev->size == self->top)
+        {
+            self->top = prev->origin;
+            *prev_link = NULL;
+            free(prev);
+        }
+
+        return CL_SUCCESS;
+    }
+
+    if (prev && prev->origin + prev->size == origin)
+    {
+        prev->size += size;
+
+        // Range may close gap between two blocks
+        if (*curr && prev->origin + prev->size == (*curr)->origin)
+        {
+            Arena_Block *next = *curr;
+
+            prev->size += next->size;
+            prev->next = next->next;
+            free(next);
+        }
+
+        return CL_SUCCESS;
+    }
+
+    if (*curr && origin + size == (*curr)->origin)
+    {
+        (*curr)->origin = origin;
+        (*curr)->size += size;
+
+        return CL_SUCCESS;
+    }
+
+    Arena_Block *block = (Arena_Block*) malloc(sizeof(*block));
+    OCL_CHECK_EXISTENCE(block, BUFFER_NOT_ALLOCATED);
+
+    block->origin = origin;
+    block->size = size;
+    block->next = *curr;
+    *curr = block;
+
+    return CL_SUCCESS;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Arena
+ *
+ * This function carves sub-buffer out of arena. Origin of sub-buffer is
+ * aligned & its size is rounded up to alignment inside arena.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Arena', in which
+ * function pointer 'Alloc' is defined to point on this function.
+ * @param[in] mem_flags OpenCL memory flags of sub-buffer. Zero inherits flags
+ * of arena buffer.
+ * @param[in] size size of sub-buffer in bytes.
+ *
+ * @return pointer to child Memory Object in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise. If arena has no room or sub-buffer can't
+ * be created, last error code of arena is set to \ref BUFFER_NOT_ALLOCATED.
+ *
+ * @warning use 'Free' function pointer of arena to destroy sub-buffer.
+ */
+static scow_Mem_Object* Arena_Alloc(scow_Arena *self, cl_mem_flags mem_flags,
+        size_t size)
+{
+    OCL_CHECK_EXISTENCE(self, VOID_MEM_OBJ_PTR);
+
+    if (!size)
+    {
+        self->error->Set_Last_Code(self->error, INVALID_BUFFER_SIZE);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    size_t aligned_size = Align_Up(self, size);
+    cl_buffer_region region = { 0, size };
+
+    if (!Take_Range(self, aligned_size, &region.origin))
+    {
+        self->error->Set_Last_Code(self->error, BUFFER_NOT_ALLOCATED);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    scow_Mem_Object *child = self->buffer->Make_Child(self->buffer, mem_flags,
+            CL_BUFFER_CREATE_TYPE_REGION, &region);
+
+    if (!child)
+    {
+        self->error->Set_Last_Code(self->error, BUFFER_NOT_ALLOCATED);
+        Give_Range(self, region.origin, aligned_size);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    self->used += aligned_size;
+
+    return child;
+}
+
+/**
+ * \related scow_Arena
+ *
+ * This function destroys sub-buffer, allocated from arena, & gives its range
+ * back to arena.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Arena', in which
+ * function pointer 'Free' is defined to point on this function.
+ * @param[in] child sub-buffer, allocated from this arena since last Reset().
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Arena_Free(scow_Arena *self, scow_Mem_Object *child)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(child, INVALID_BUFFER_GIVEN);
+
+    size_t origin = child->origin, aligned_size = Align_Up(self, child->size);
+
+    if (child->obj_paternity != CHILD_OBJECT ||
+            origin + aligned_size > self->top)
+    {
+        return WRONG_PARENT_OBJECT;
+    }
+
+    ret_code ret = child->Destroy(child);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->used -= aligned_size;
+
+    return Give_Range(self, origin, aligned_size);
+}
+
+/**
+ * \related scow_Arena
+ *
+ * This function makes whole arena free at once. Sub-buffers, allocated
+ * before, must not be used after, as their ranges will be reused; they still
+ * have to be destroyed by their own 'Destroy' function pointer.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Arena', in which
+ * function pointer 'Reset' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Arena_Reset(scow_Arena *self)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    while (self->free_blocks)
+    {
+        Arena_Block *block = self->free_blocks;
+
+        self->free_blocks = block->next;
+        free(block);
+    }
+
+    self->top = 0;
+    self->used = 0;
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Arena
+ *
+ * This function releases arena buffer & frees memory, allocated for arena.
+ * OpenCL keeps buffer alive, until all sub-buffers are released.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Arena', in which
+ * function pointer 'Destroy' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Arena_Destroy(scow_Arena *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    self->Reset(self);
+
+    if (self->buffer)
+    {
+        self->buffer->Destroy(self->buffer);
+    }
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Arena
+ *
+ * This function allocates memory for structure, reserves OpenCL buffer &
+ * sets function pointers. Alignment is taken from base address alignment of
+ * Device.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives context.
+ * @param[in] mem_flags OpenCL memory flags of arena buffer.
+ * @param[in] size size of arena buffer in bytes.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_ARENA_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Arena* Make_Arena(scow_Steel_Thread *parent_thread,
+        cl_mem_flags mem_flags, size_t size)
+{
+    OCL_CHECK_EXISTENCE(parent_thread, VOID_ARENA_PTR);
+
+    scow_Arena *self = (scow_Arena*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_ARENA_PTR);
+
+    self->Alloc = Arena_Alloc;
+    self->Free = Arena_Free;
+    self->Reset = Arena_Reset;
+    self->Destroy = Arena_Destroy;
+
+    // Alignment is given by Device in bits
+    self->alignment = parent_thread->device->mem_base_addr_align / 8;
+    if (!self->alignment)
+    {
+        self->alignment = 1;
+    }
+
+    self->error = Make_Error();
+    OCL_CHECK_EXISTENCE_AND_DO(self->error, self->Destroy(self),
+            VOID_ARENA_PTR);
+
+    self->buffer = Make_Buffer(parent_thread, mem_flags, size, NULL);
+    OCL_CHECK_EXISTENCE_AND_DO(self->buffer, self->Destroy(self),
+            VOID_ARENA_PTR);
+
+    return self;
+}
@@ -0,0 +1,465 @@
+/*
+ * @file buffer_pool.c
+ * @brief Provides pool of OpenCL buffers, recycled by size classes
+ *
+ * @see buffer_pool.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+
+#include "buffer_pool.h"
+#include "steel_thread.h"
+
+/*! \cond PRIVATE */
+// Index of the smallest size class, which fits given size
+static cl_uint Get_Size_Class(size_t size)
+{
+    cl_uint size_class = BUFFER_POOL_MIN_CLASS_LOG2;
+
+    while (size_class < BUFFER_POOL_NUM_CLASSES - 1 &&
+            ((size_t) 1 << size_class) < size)
+    {
+        size_class++;
+    }
+
+    return size_class;
+}
+
+static void Release_Entry(Buffer_Pool_Entry *entry)
+{
+    for (cl_uint i = 0; i < BUFFER_POOL_NUM_FENCES; i++)
+    {
+        if (entry->fences[i])
+        {
+            clReleaseEvent(entry->fences[i]);
+        }
+    }
+
+    clReleaseMemObject(entry->mem);
+    free(entry);
+}
+
+/* Enqueues marker into each queue of Steel Thread, so that it completes after
+ * commands, which may use buffer. Queues are flushed, not to keep markers
+ * waiting for the next flush. */
+static ret_code Fence_Entry(scow_Buffer_Pool *self, Buffer_Pool_Entry *entry)
+{
+    scow_Steel_Thread *thread = self->parent_thread;
+    cl_command_queue queues[BUFFER_POOL_NUM_FENCES] = { thread->q_cmd,
+            thread->q_data_htod, thread->q_data_dtoh, thread->q_data_dtod };
+
+    for (cl_uint i = 0; i < BUFFER_POOL_NUM_FENCES; i++)
+    {
+        if (!queues[i])
+        {
+            continue;
+        }
+
+        ret_code ret = clEnqueueMarkerWithWaitList(queues[i], 0, NULL,
+                &entry->fences[i]);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+        clFlush(queues[i]);
+    }
+
+    return CL_SUCCESS;
+}
+
+// Checks, if commands before return of buffer are done. Complete fences go.
+static int Is_Entry_Idle(Buffer_Pool_Entry *entry)
+{
+    int is_idle = 1;
+
+    for (cl_uint i = 0; i < BUFFER_POOL_NUM_FENCES; i++)
+    {
+        cl_int status = CL_COMPLETE;
+
+        if (!entry->fences[i])
+        {
+            continue;
+        }
+
+        cl_int ret = clGetEventInfo(entry->fences[i],
+                CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status,
+                NULL);
+
+        // Negative status means, that command was terminated abnormally
+        if (ret == CL_SUCCESS && (status == CL_COMPLETE || status < 0))
+        {
+            clReleaseEvent(entry->fences[i]);
+            entry->fences[i] = NULL;
+        }
+        else
+        {
+            is_idle = 0;
+        }
+    }
+
+    return is_idle;
+}
+
+// Releases free buffers of the largest classes first. Lock must be held.
+static void Trim_Locked(scow_Buffer_Pool *self, size_t max_cached_bytes)
+{
+    for (cl_uint i = BUFFER_POOL_NUM_CLASSES; i-- > 0;)
+    {
+        while (self->stats.cached_bytes > max_cached_bytes &&
+                self->free_lists[i])
+        {
+            Buffer_Pool_Entry *entry = self->free_lists[i];
+
+            self->free_lists[i] = entry->next;
+            self->stats.cached_bytes -= (size_t) 1 << i;
+            self->stats.num_trimmed++;
+
+            // Runtime keeps buffer alive for commands, which still use it
+            Release_Entry(entry);
+        }
+    }
+}
+
+/* Takes free buffer from pool & counts hit or miss. NULL if there is none.
+ * Buffers, which may still be used by commands, are skipped. */
+static cl_mem Buffer_Pool_Take(scow_Buffer_Pool *self, cl_mem_flags mem_flags,
+        size_t size)
+{
+    if (!self || !size || (mem_flags & CL_MEM_USE_HOST_PTR) ||
+            (mem_flags & CL_MEM_COPY_HOST_PTR))
+    {
+        return NULL;
+    }
+
+    cl_uint size_class = Get_Size_Class(size);
+    cl_mem mem = NULL;
+
+    pthread_mutex_lock(&self->lock);
+
+    for (Buffer_Pool_Entry **curr = &self->free_lists[size_class]; *curr;
+            curr = &(*curr)->next)
+    {
+        if ((*curr)->mem_flags == mem_flags && Is_Entry_Idle(*curr))
+        {
+            Buffer_Pool_Entry *entry = *curr;
+
+            *curr = entry->next;
+            mem = entry->mem;
+            free(entry);
+
+            self->stats.cached_bytes -= (size_t) 1 << size_class;
+            break;
+        }
+    }
+
+    if (mem)
+    {
+        self->stats.num_hits++;
+    }
+    else
+    {
+        self->stats.num_misses++;
+    }
+
+    pthread_mutex_unlock(&self->lock);
+
+    return mem;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function takes free buffer of proper size class & memory flags from
+ * pool or creates new one, if there is no such buffer. If OpenCL runs out of
+ * memory, all free buffers are released & creation is tried once more.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Buffer_Pool', in which
+ * function pointer 'Acquire' is defined to point on this function.
+ * @param[in] mem_flags OpenCL memory flags. Flags, which refer to Host
+ * pointer, are not allowed.
+ * @param[in] size required size in bytes. Buffer may be larger.
+ * @param[out] ret error code of type ret_code. May be NULL.
+ *
+ * @return OpenCL buffer in case of success, NULL otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static cl_mem Buffer_Pool_Acquire(scow_Buffer_Pool *self,
+        cl_mem_flags mem_flags, size_t size, ret_code *ret)
+{
+    cl_int status = INVALID_BUFFER_GIVEN;
+    cl_mem mem = Buffer_Pool_Take(self, mem_flags, size);
+
+    if (mem)
+    {
+        status = CL_SUCCESS;
+    }
+    else if (self && size && !(mem_flags & CL_MEM_USE_HOST_PTR) &&
+            !(mem_flags & CL_MEM_COPY_HOST_PTR))
+    {
+        size_t class_size = (size_t) 1 << Get_Size_Class(size);
+
+        mem = clCreateBuffer(self->parent_thread->context, mem_flags,
+                class_size, NULL, &status);
+
+        if (status == CL_MEM_OBJECT_ALLOCATION_FAILURE ||
+                status == CL_OUT_OF_RESOURCES)
+        {
+            self->Trim(self, 0);
+            mem = clCreateBuffer(self->parent_thread->context, mem_flags,
+                    class_size, NULL, &status);
+        }
+
+        if (status != CL_SUCCESS)
+        {
+            self->error->Set_Last_Code(self->error, status);
+            mem = NULL;
+        }
+    }
+
+    if (ret)
+    {
+        *ret = status;
+    }
+
+    return mem;
+}
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function returns buffer, acquired from pool, for reuse. Buffer is
+ * released instead, if it's still referenced (e. g. by sub-buffers) or if it
+ * doesn't fit into budget. Buffer is reused only after commands, which were
+ * enqueued into queues of parent Steel Thread by this moment, complete.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Buffer_Pool', in which
+ * function pointer 'Recycle' is defined to point on this function.
+ * @param[in] mem OpenCL buffer, acquired from this pool.
+ * @param[in] mem_flags memory flags, which buffer was acquired with.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Buffer_Pool_Recycle(scow_Buffer_Pool *self, cl_mem mem,
+        cl_mem_flags mem_flags)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(mem, INVALID_BUFFER_GIVEN);
+
+    size_t size = 0;
+    cl_uint ref_count = 0;
+
+    ret_code ret = clGetMemObjectInfo(mem, CL_MEM_SIZE, sizeof(size), &size,
+            NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    ret = clGetMemObjectInfo(mem, CL_MEM_REFERENCE_COUNT, sizeof(ref_count),
+            &ref_count, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    cl_uint size_class = Get_Size_Class(size);
+    Buffer_Pool_Entry *entry = NULL;
+
+    // Sub-buffers keep their parent alive, so it can't be given to other user
+    if (ref_count == 1 && size == ((size_t) 1 << size_class))
+    {
+        // Fences are NULL, until they are enqueued
+        entry = (Buffer_Pool_Entry*) calloc(1, sizeof(*entry));
+    }
+
+    if (!entry)
+    {
+        return clReleaseMemObject(mem);
+    }
+
+    entry->mem = mem;
+    entry->mem_flags = mem_flags;
+
+    // Buffer, which can't be fenced, is just released
+    if (Fence_Entry(self, entry) != CL_SUCCESS)
+    {
+        Release_Entry(entry);
+        return CL_SUCCESS;
+    }
+
+    pthread_mutex_lock(&self->lock);
+
+    if (size <= self->stats.budget)
+    {
+        Trim_Locked(self, self->stats.budget - size);
+
+        entry->next = self->free_lists[size_class];
+        self->free_lists[size_class] = entry;
+        self->stats.cached_bytes += size;
+        entry = NULL;
+    }
+
+    pthread_mutex_unlock(&self->lock);
+
+    if (entry)
+    {
+        Release_Entry(entry);
+    }
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function sets maximal amount of memory, kept in free buffers, &
+ * releases free buffers, which don't fit into it.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Buffer_Pool', in which
+ * function pointer 'Set_Budget' is defined to point on this function.
+ * @param[in] budget maximal amount of memory in bytes. Zero disables caching.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Buffer_Pool_Set_Budget(scow_Buffer_Pool *self, size_t budget)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    pthread_mutex_lock(&self->lock);
+
+    self->stats.budget = budget;
+    Trim_Locked(self, budget);
+
+    pthread_mutex_unlock(&self->lock);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function releases free buffers of the largest classes, until amount of
+ * memory in free buffers fits into given limit. Budget is left untouched.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Buffer_Pool', in which
+ * function pointer 'Trim' is defined to point on this function.
+ * @param[in] max_cached_bytes amount of memory in bytes, which may be kept.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Buffer_Pool_Trim(scow_Buffer_Pool *self,
+        size_t max_cached_bytes)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    pthread_mutex_lock(&self->lock);
+    Trim_Locked(self, max_cached_bytes);
+    pthread_mutex_unlock(&self->lock);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function takes consistent snapshot of pool statistics.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Buffer_Pool', in which
+ * function pointer 'Get_Stats' is defined to point on this function.
+ * @param[out] stats statistics of pool.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Buffer_Pool_Get_Stats(scow_Buffer_Pool *self,
+        scow_Buffer_Pool_Stats *stats)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(stats, INVALID_BUFFER_GIVEN);
+
+    pthread_mutex_lock(&self->lock);
+    *stats = self->stats;
+    pthread_mutex_unlock(&self->lock);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function releases all free buffers & frees memory, allocated for pool.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Buffer_Pool', in which
+ * function pointer 'Destroy' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Buffer_Pool_Destroy(scow_Buffer_Pool *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    Trim_Locked(self, 0);
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    pthread_mutex_destroy(&self->lock);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Buffer_Pool
+ *
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives context.
+ * @param[in] budget maximal amount of memory in bytes, kept in free buffers.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_BUFFER_POOL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. Buffers, acquired from pool, may outlive it.
+ */
+scow_Buffer_Pool* Make_Buffer_Pool(struct scow_Steel_Thread *parent_thread,
+        size_t budget)
+{
+    OCL_CHECK_EXISTENCE(parent_thread, VOID_BUFFER_POOL_PTR);
+
+    scow_Buffer_Pool *self = (scow_Buffer_Pool*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_BUFFER_POOL_PTR);
+
+    pthread_mutex_init(&self->lock, NULL);
+
+    self->Acquire = Buffer_Pool_Acquire;
+    self->Recycle = Buffer_Pool_Recycle;
+    self->Set_Budget = Buffer_Pool_Set_Budget;
+    self->Trim = Buffer_Pool_Trim;
+    self->Get_Stats = Buffer_Pool_Get_Stats;
+    self->Destroy = Buffer_Pool_Destroy;
+
+    self->parent_thread = parent_thread;
+    self->stats.budget = budget;
+    self->error = Make_Error();
+    OCL_CHECK_EXISTENCE_AND_DO(self->error, self->Destroy(self),
+            VOID_BUFFER_POOL_PTR);
+
+    return self;
+}
@@ -242,6 +242,23 @@ static ret_code Device_Gather_Info(scow_Device* self, DEVICE_INFO_PARAM param)
         OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, CANT_QUERY_DEVICE_PARAM);
     }
 
+    if (param == DEVICE_TYPE || param == DEVICE_ALL_AVAILABLE)
+    {
+        ret = clGetDeviceInfo(self->device_id,
+        CL_DEVICE_TYPE, sizeof(cl_device_type), &self->device_type, NULL);
+
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, CANT_QUERY_DEVICE_PARAM);
+    }
+
+    if (param == DEVICE_HOST_UNIFIED_MEMORY || param == DEVICE_ALL_AVAILABLE)
+    {
+        ret = clGetDeviceInfo(self->device_id,
+        CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(cl_bool),
+                &self->host_unified_memory, NULL);
+
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, CANT_QUERY_DEVICE_PARAM);
+    }
+
     return CL_SUCCESS;
 }
 
@@ -348,6 +365,15 @@ static ret_code Device_Print_Info(const scow_Device* self,
         fprintf(stdout, "native float vector length: %u\n",
                 self->native_vector_width_float);
 
+    if (param == DEVICE_TYPE || param == DEVICE_ALL_AVAILABLE)
+        fprintf(stdout, "device type:                %s\n",
+                (self->device_type & CL_DEVICE_TYPE_CPU) ? "CPU" :
+                (self->device_type & CL_DEVICE_TYPE_GPU) ? "GPU" : "other");
+
+    if (param == DEVICE_HOST_UNIFIED_MEMORY || param == DEVICE_ALL_AVAILABLE)
+        fprintf(stdout, "host unified memory:        %s\n",
+                self->host_unified_memory ? "yes" : "no");
+
     return CL_SUCCESS;
 }
 
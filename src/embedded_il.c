@@ -0,0 +1,55 @@
+/*
+ * @file embedded_il.c
+ * @brief Provides access to OpenCL programs, compiled to SPIR-V at build time
+ * & embedded into library
+ *
+ * @see embedded_il.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <string.h>
+
+#include "embedded_il.h"
+
+/*! \cond PRIVATE */
+/* Table is generated by EmbedIL.cmake at build time. It's terminated by entry
+ * with NULL name. */
+extern const scow_Embedded_IL scow_embedded_il_table[];
+/*! \endcond */
+
+/**
+ * \related scow_Embedded_IL
+ *
+ * This function looks up program, embedded into library, by name.
+ *
+ * @param[in] name name of .cl file without extension.
+ *
+ * @return pointer to embedded program in case of success, NULL otherwise.
+ */
+const scow_Embedded_IL* Find_Embedded_IL(const char *name)
+{
+    if (!name)
+    {
+        return NULL;
+    }
+
+    for (const scow_Embedded_IL *curr = scow_embedded_il_table; curr->name;
+            curr++)
+    {
+        if (strcmp(curr->name, name) == 0)
+        {
+            return curr;
+        }
+    }
+
+    return NULL;
+}
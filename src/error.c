@@ -61,6 +61,24 @@ static ret_code Error_Destroy(scow_Error* self)
     return CL_SUCCESS;
 }
 
+/**
+ * \related cl_Error_t
+ *
+ * This function does nothing, as structure, initialized by Init_Error(), is
+ * embedded into its owner & its memory is freed together with owner.
+ *
+ * @param[in,out] self pointer to structure 'self' of type 'cl_Error_t',
+ * in which fptr 'Destroy' is defined to point on this function
+ *
+ * @return CL_SUCCESS in case of success, error code otherwise.
+ */
+static ret_code Error_Release(scow_Error* self)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    return CL_SUCCESS;
+}
+
 /**
  * \related cl_Error_t
  *
@@ -126,6 +144,10 @@ static const char* Error_Get_Error_Message(const scow_Error* self)
         ;
         break;
 
+    case CANT_ACCESS_FILE:
+        strcpy(error_message, "Can't open, resize or map file.\n");
+        break;
+
     case INVALID_BLOCKING_FLAG:
         strcpy(error_message,
                 "Invalid blocking flag - not CL_TRUE, nor CL_FALSE.\n");
@@ -253,6 +275,21 @@ static const char* Error_Get_Error_Message(const scow_Error* self)
         strcpy(error_message, "Invalid or non-existent OpenCL event.\n");
         break;
 
+    case CANT_ACCESS_BINARY_CACHE:
+        strcpy(error_message,
+                "Can't access OpenCL program binary in on-disk cache.\n");
+        break;
+
+    case IL_NOT_SUPPORTED:
+        strcpy(error_message,
+                "Device doesn't support programs in intermediate language.\n");
+        break;
+
+    case SUB_BUFFER_MISALIGNED:
+        strcpy(error_message,
+                "Sub-buffer origin isn't aligned to Device base address.\n");
+        break;
+
     case VALUE_OUT_OF_RANGE:
         strcpy(error_message, "Value lays out of acceptable range.\n");
         break;
@@ -270,6 +307,11 @@ static const char* Error_Get_Error_Message(const scow_Error* self)
                 "Can't set default object. Possibly - can't lock mutex.\n");
         break;
 
+    case KERNEL_IN_USE:
+        strcpy(error_message,
+                "Can't acquire kernel - all its instances are in use.\n");
+        break;
+
     case CALLING_STUB_ACCESSOR:
         strcpy(error_message,
                 "Can't call non-implemented function through pointer.\n");
@@ -312,7 +354,32 @@ scow_Error* Make_Error(void)
     scow_Error* self = (scow_Error*) calloc(1, sizeof(*self));
     OCL_CHECK_EXISTENCE(self, VOID_ERROR_PTR);
 
+    Init_Error(self);
     self->Destroy = Error_Destroy;
+
+    return self;
+}
+
+/**
+ * \related cl_Error_t
+ *
+ * This function initializes structure of type 'cl_Error_t', which is embedded
+ * into another structure, & sets function pointers.
+ *
+ * @param[out] self pointer to structure to initialize.
+ *
+ * @return pointer to initialized structure in case of success,
+ * \ref VOID_ERROR_PTR otherwise.
+ *
+ * @warning 'Destroy' function pointer doesn't free memory of structure.
+ */
+scow_Error* Init_Error(scow_Error* self)
+{
+    OCL_CHECK_EXISTENCE(self, VOID_ERROR_PTR);
+
+    self->rt_last_code = CL_SUCCESS;
+
+    self->Destroy = Error_Release;
     self->Get_Last_Code = Error_Get_Last_Code;
     self->Set_Last_Code = Error_Set_Last_Code;
     self->Get_Error_Message = Error_Get_Error_Message;
@@ -0,0 +1,322 @@
+/*
+ * @file file_buffer.c
+ * @brief Provides loading of files into buffers & storing buffers into files
+ *
+ * @see file_buffer.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_buffer.h"
+#include "staging_ring.h"
+#include "steel_thread.h"
+
+/*! \cond PRIVATE */
+// Mapping of file, which is released with Buffer, made over it
+typedef struct File_Mapping
+{
+    void *ptr;
+    size_t size;
+} File_Mapping;
+
+static void CL_CALLBACK Unmap_File(cl_mem memobj, void *user_data)
+{
+    File_Mapping *mapping = (File_Mapping*) user_data;
+
+    (void) memobj;
+
+    munmap(mapping->ptr, mapping->size);
+    free(mapping);
+}
+
+// Pages, which were copied, aren't needed anymore
+static void Drop_Pages(unsigned char *ptr, size_t size)
+{
+    madvise(ptr, size, MADV_DONTNEED);
+}
+
+static scow_Mem_Object* Make_Buffer_Over_Mapping(scow_Steel_Thread *thread,
+        cl_mem_flags mem_flags, void *ptr, size_t size)
+{
+    File_Mapping *mapping = (File_Mapping*) malloc(sizeof(*mapping));
+    OCL_CHECK_EXISTENCE_AND_DO(mapping, munmap(ptr, size), VOID_MEM_OBJ_PTR);
+
+    mapping->ptr = ptr;
+    mapping->size = size;
+
+    scow_Mem_Object *buffer = Make_Buffer(thread,
+            mem_flags | CL_MEM_USE_HOST_PTR, size, ptr);
+    if (!buffer)
+    {
+        Unmap_File(NULL, mapping);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    ret_code ret = clSetMemObjectDestructorCallback(buffer->cl_mem_object,
+            Unmap_File, mapping);
+    if (ret != CL_SUCCESS)
+    {
+        buffer->Destroy(buffer);
+        Unmap_File(NULL, mapping);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    return buffer;
+}
+
+static scow_Mem_Object* Make_Buffer_By_Chunks(scow_Steel_Thread *thread,
+        cl_mem_flags mem_flags, unsigned char *ptr, size_t size)
+{
+    size_t chunk = (size < FILE_BUFFER_CHUNK_SIZE) ? size :
+            FILE_BUFFER_CHUNK_SIZE;
+
+    scow_Mem_Object *buffer = Make_Buffer(thread, mem_flags, size, NULL);
+    OCL_CHECK_EXISTENCE(buffer, VOID_MEM_OBJ_PTR);
+
+    scow_Staging_Ring *ring = Make_Staging_Ring(thread, FILE_BUFFER_NUM_SLOTS,
+            chunk);
+    OCL_CHECK_EXISTENCE_AND_DO(ring, buffer->Destroy(buffer),
+            VOID_MEM_OBJ_PTR);
+
+    ret_code ret = CL_SUCCESS;
+
+    madvise(ptr, size, MADV_SEQUENTIAL);
+
+    // Copying of chunk overlaps upload of the previous one
+    for (size_t offset = 0; offset < size && ret == CL_SUCCESS;
+            offset += chunk)
+    {
+        size_t length = (size - offset < chunk) ? size - offset : chunk;
+
+        void *staging = ring->Acquire(ring);
+        if (!staging)
+        {
+            ret = ring->error->Get_Last_Code(ring->error);
+            break;
+        }
+
+        memcpy(staging, ptr + offset, length);
+        Drop_Pages(ptr + offset, length);
+
+        ret = ring->Upload(ring, staging, buffer, offset, length,
+                DONT_MEASURE, NULL);
+    }
+
+    // Waits for uploads in flight
+    ring->Destroy(ring);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, buffer->Destroy(buffer),
+            VOID_MEM_OBJ_PTR);
+
+    return buffer;
+}
+
+static ret_code Write_By_Chunks(scow_Mem_Object *buffer, unsigned char *ptr)
+{
+    size_t size = buffer->size;
+    size_t chunk = (size < FILE_BUFFER_CHUNK_SIZE) ? size :
+            FILE_BUFFER_CHUNK_SIZE;
+
+    scow_Staging_Ring *ring = Make_Staging_Ring(buffer->parent_thread,
+            FILE_BUFFER_NUM_SLOTS, chunk);
+    OCL_CHECK_EXISTENCE(ring, BUFFER_NOT_ALLOCATED);
+
+    ret_code ret = CL_SUCCESS;
+    unsigned char *prev = NULL;
+    size_t prev_offset = 0, prev_length = 0;
+
+    // Download of chunk overlaps copying of the previous one
+    for (size_t offset = 0; ret == CL_SUCCESS; offset += chunk)
+    {
+        unsigned char *staging = NULL;
+        size_t length = 0;
+
+        if (offset < size)
+        {
+            length = (size - offset < chunk) ? size - offset : chunk;
+
+            staging = (unsigned char*) ring->Acquire(ring);
+            if (!staging)
+            {
+                ret = ring->error->Get_Last_Code(ring->error);
+                break;
+            }
+
+            ret = ring->Download(ring, staging, buffer, offset, length,
+                    DONT_MEASURE, NULL);
+        }
+
+        if (prev && ret == CL_SUCCESS)
+        {
+            ret = ring->Wait(ring, prev);
+
+            if (ret == CL_SUCCESS)
+            {
+                memcpy(ptr + prev_offset, prev, prev_length);
+                Drop_Pages(ptr + prev_offset, prev_length);
+            }
+        }
+
+        if (!staging)
+        {
+            break;
+        }
+
+        prev = staging;
+        prev_offset = offset;
+        prev_length = length;
+    }
+
+    ring->Destroy(ring);
+
+    return ret;
+}
+/*! \endcond */
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function makes Buffer with content of file. File is mapped into memory,
+ * so that it isn't read into heap.
+ *
+ * If parent Steel Thread is in zero-copy mode, Buffer is made over mapped
+ * file with CL_MEM_USE_HOST_PTR. File isn't changed by Buffer writes, as
+ * mapping is private, & is unmapped when Buffer is released.
+ *
+ * Otherwise file is streamed into Buffer by chunks of
+ * \ref FILE_BUFFER_CHUNK_SIZE through ring of pinned staging slots, & pages
+ * of file are dropped as soon as they are copied, so that resident memory
+ * stays bounded regardless of file size.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives OpenCL context, etc
+ * @param[in] mem_flags OpenCL memory flags. Flags of Host pointer usage are
+ * ignored.
+ * @param[in] file_name path to file.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated
+ * by this function.
+ */
+scow_Mem_Object* Make_Buffer_From_File(scow_Steel_Thread *parent_thread,
+        cl_mem_flags mem_flags, const char *file_name)
+{
+    OCL_CHECK_EXISTENCE(parent_thread, VOID_MEM_OBJ_PTR);
+    OCL_CHECK_EXISTENCE(file_name, VOID_MEM_OBJ_PTR);
+
+    mem_flags &= ~(CL_MEM_USE_HOST_PTR | CL_MEM_ALLOC_HOST_PTR |
+            CL_MEM_COPY_HOST_PTR);
+
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+    {
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) || file_stat.st_size <= 0)
+    {
+        close(fd);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    size_t size = (size_t) file_stat.st_size;
+
+    // Private writable mapping lets kernels write into Buffer over it
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED)
+    {
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    if (parent_thread->zero_copy)
+    {
+        return Make_Buffer_Over_Mapping(parent_thread, mem_flags, ptr, size);
+    }
+
+    scow_Mem_Object *buffer = Make_Buffer_By_Chunks(parent_thread, mem_flags,
+            (unsigned char*) ptr, size);
+    munmap(ptr, size);
+
+    return buffer;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function stores content of Buffer into file, which is created or
+ * truncated. File is mapped into memory & filled directly in zero-copy mode
+ * of parent Steel Thread, or by chunks through staging slots otherwise.
+ *
+ * @param[in] buffer Buffer to store.
+ * @param[in] file_name path to file.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+ret_code Buffer_Write_To_File(scow_Mem_Object *buffer, const char *file_name)
+{
+    OCL_CHECK_EXISTENCE(buffer, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(file_name, INVALID_BUFFER_GIVEN);
+
+    if (buffer->obj_mem_type != BUFFER)
+    {
+        return INVALID_ARG_TYPE;
+    }
+
+    if (!buffer->size)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    int fd = open(file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return CANT_ACCESS_FILE;
+    }
+
+    if (ftruncate(fd, (off_t) buffer->size))
+    {
+        close(fd);
+        return CANT_ACCESS_FILE;
+    }
+
+    void *ptr = mmap(NULL, buffer->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED)
+    {
+        return CANT_ACCESS_FILE;
+    }
+
+    ret_code ret = (buffer->parent_thread->zero_copy) ?
+            buffer->Read_Range(buffer, CL_TRUE, 0, buffer->size, ptr,
+                    DONT_MEASURE, NULL, NULL) :
+            Write_By_Chunks(buffer, (unsigned char*) ptr);
+
+    munmap(ptr, buffer->size);
+
+    return ret;
+}
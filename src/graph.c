@@ -0,0 +1,775 @@
+/*
+ * @file graph.c
+ * @brief Provides recorded graphs of OpenCL commands with low overhead replay
+ *
+ * @see graph.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <CL/cl_ext.h>
+
+#include "graph.h"
+#include "steel_thread.h"
+#include "platform.h"
+#include "device.h"
+
+/*! \cond PRIVATE */
+#undef GRAPH_INITIAL_CAPACITY
+#define GRAPH_INITIAL_CAPACITY      (16)
+
+#ifdef cl_khr_command_buffer
+// Command buffer with entry points of extension, which implements it
+typedef struct Graph_Cmd_Buf
+{
+    clCreateCommandBufferKHR_fn Create;
+    clCommandNDRangeKernelKHR_fn Command_ND_Range;
+    clFinalizeCommandBufferKHR_fn Finalize;
+    clEnqueueCommandBufferKHR_fn Enqueue;
+    clReleaseCommandBufferKHR_fn Release;
+
+    cl_command_buffer_khr cmd_buf;
+    cl_sync_point_khr* sync_points;
+} Graph_Cmd_Buf;
+
+static Graph_Cmd_Buf* Make_Graph_Cmd_Buf(scow_Graph *self)
+{
+    cl_platform_id platform = self->parent_steel_thread->platform->platform;
+
+    if (!strstr(self->parent_steel_thread->device->extensions,
+            "cl_khr_command_buffer"))
+    {
+        return NULL;
+    }
+
+    Graph_Cmd_Buf *cb = (Graph_Cmd_Buf*) calloc(1, sizeof(*cb));
+    OCL_CHECK_EXISTENCE(cb, NULL);
+
+    cb->Create = (clCreateCommandBufferKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(platform,
+                    "clCreateCommandBufferKHR");
+    cb->Command_ND_Range = (clCommandNDRangeKernelKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(platform,
+                    "clCommandNDRangeKernelKHR");
+    cb->Finalize = (clFinalizeCommandBufferKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(platform,
+                    "clFinalizeCommandBufferKHR");
+    cb->Enqueue = (clEnqueueCommandBufferKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(platform,
+                    "clEnqueueCommandBufferKHR");
+    cb->Release = (clReleaseCommandBufferKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(platform,
+                    "clReleaseCommandBufferKHR");
+
+    cb->sync_points = (cl_sync_point_khr*) calloc(self->num_nodes,
+            sizeof(*cb->sync_points));
+
+    if (!cb->Create || !cb->Command_ND_Range || !cb->Finalize || !cb->Enqueue
+            || !cb->Release || !cb->sync_points)
+    {
+        free(cb->sync_points);
+        free(cb);
+        return NULL;
+    }
+
+    return cb;
+}
+
+static void Destroy_Graph_Cmd_Buf(Graph_Cmd_Buf *cb)
+{
+    if (cb->cmd_buf)
+    {
+        cb->Release(cb->cmd_buf);
+    }
+
+    free(cb->sync_points);
+    free(cb);
+}
+
+/* Command buffer captures kernel arguments at recording, so it's recorded
+ * again, when they are bound since. Arguments may be flushed to OpenCL kernel
+ * by other enqueues meanwhile, so their dirty flags aren't reliable here. */
+static ret_code Record_Graph_Cmd_Buf(scow_Graph *self)
+{
+    Graph_Cmd_Buf *cb = (Graph_Cmd_Buf*) self->cmd_buf;
+    cl_int ret = CL_SUCCESS;
+
+    if (cb->cmd_buf)
+    {
+        cb->Release(cb->cmd_buf);
+        cb->cmd_buf = NULL;
+    }
+
+    cb->cmd_buf = cb->Create(1, &self->nodes[0].queue, NULL, &ret);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    for (cl_uint i = 0; i < self->num_nodes; i++)
+    {
+        Graph_Node *node = &self->nodes[i];
+        cl_sync_point_khr deps[GRAPH_MAX_DEPS];
+
+        for (cl_uint j = 0; j < node->num_deps; j++)
+        {
+            deps[j] = cb->sync_points[node->deps[j]];
+        }
+
+        ret = node->kernel->Flush_Args(node->kernel);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+        node->recorded_generation = node->kernel->bind_generation;
+
+        ret = cb->Command_ND_Range(cb->cmd_buf, NULL, NULL,
+                node->kernel->kernel, node->work_dim, NULL, node->global_size,
+                node->has_local_size ? node->local_size : NULL,
+                node->num_deps, node->num_deps ? deps : NULL,
+                &cb->sync_points[i], NULL);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    }
+
+    return cb->Finalize(cb->cmd_buf);
+}
+#endif /* cl_khr_command_buffer */
+
+static ret_code Add_Node(scow_Graph *self, const Graph_Node *node,
+        cl_uint *node_id)
+{
+    OCL_CHECK_EXISTENCE(node->queue, INVALID_BUFFER_GIVEN);
+
+    // Graph is fixed after finalization
+    if (self->is_finalized)
+    {
+        return BUFFER_IN_USE;
+    }
+
+    if (node->num_deps > GRAPH_MAX_DEPS)
+    {
+        return VALUE_OUT_OF_RANGE;
+    }
+
+    // Nodes may depend only on nodes, recorded before them
+    for (cl_uint i = 0; i < node->num_deps; i++)
+    {
+        if (node->deps[i] >= self->num_nodes)
+        {
+            return VALUE_OUT_OF_RANGE;
+        }
+    }
+
+    if (self->num_nodes == self->capacity)
+    {
+        cl_uint capacity = self->capacity ?
+                2 * self->capacity : GRAPH_INITIAL_CAPACITY;
+
+        Graph_Node *nodes = (Graph_Node*) realloc(self->nodes,
+                capacity * sizeof(*nodes));
+        OCL_CHECK_EXISTENCE(nodes, BUFFER_NOT_ALLOCATED);
+
+        self->nodes = nodes;
+        self->capacity = capacity;
+    }
+
+    self->nodes[self->num_nodes] = *node;
+
+    if (node_id)
+    {
+        *node_id = self->num_nodes;
+    }
+
+    self->num_nodes++;
+
+    return CL_SUCCESS;
+}
+
+static void Set_Node_Deps(Graph_Node *node, cl_uint num_deps,
+        const cl_uint *deps)
+{
+    node->num_deps = deps ? num_deps : 0;
+
+    for (cl_uint i = 0; i < node->num_deps && i < GRAPH_MAX_DEPS; i++)
+    {
+        node->deps[i] = deps[i];
+    }
+}
+
+static void Release_Events(cl_event *events, cl_uint num_events)
+{
+    for (cl_uint i = 0; i < num_events; i++)
+    {
+        clReleaseEvent(events[i]);
+    }
+}
+
+static ret_code Enqueue_Node(Graph_Node *node, cl_uint num_wait,
+        const cl_event *wait_list, cl_event *event)
+{
+    cl_int ret;
+
+    switch (node->type)
+    {
+    case GRAPH_NODE_KERNEL:
+        ret = node->kernel->Flush_Args(node->kernel);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+        return clEnqueueNDRangeKernel(node->queue, node->kernel->kernel,
+                node->work_dim, NULL, node->global_size,
+                node->has_local_size ? node->local_size : NULL, num_wait,
+                wait_list, event);
+
+    case GRAPH_NODE_WRITE:
+        return clEnqueueWriteBuffer(node->queue, node->mem_obj->cl_mem_object,
+                CL_FALSE, 0, node->mem_obj->size, node->host_ptr, num_wait,
+                wait_list, event);
+
+    case GRAPH_NODE_READ:
+        return clEnqueueReadBuffer(node->queue, node->mem_obj->cl_mem_object,
+                CL_FALSE, 0, node->mem_obj->size, node->host_ptr, num_wait,
+                wait_list, event);
+
+    case GRAPH_NODE_COPY:
+        return clEnqueueCopyBuffer(node->queue, node->mem_obj->cl_mem_object,
+                node->dest->cl_mem_object, 0, 0, node->mem_obj->size, num_wait,
+                wait_list, event);
+
+    default:
+        break;
+    }
+
+    return INVALID_ARG_TYPE;
+}
+
+// Enqueue recorded commands one by one, waiting on events of dependencies
+static ret_code Replay_Nodes(scow_Graph *self, cl_uint evt_wait_list_size,
+        const cl_event *evt_wait_list, cl_event *replay_done)
+{
+    cl_int ret;
+    cl_uint num_sinks = 0;
+
+    for (cl_uint i = 0; i < self->num_nodes; i++)
+    {
+        Graph_Node *node = &self->nodes[i];
+        cl_event deps[GRAPH_MAX_DEPS];
+
+        for (cl_uint j = 0; j < node->num_deps; j++)
+        {
+            deps[j] = self->events[node->deps[j]];
+        }
+
+        // Only roots wait for external events, others wait for them through roots
+        ret = node->num_deps ?
+                Enqueue_Node(node, node->num_deps, deps, &self->events[i]) :
+                Enqueue_Node(node, evt_wait_list_size, evt_wait_list,
+                        &self->events[i]);
+
+        if (ret != CL_SUCCESS)
+        {
+            Release_Events(self->events, i);
+            OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+        }
+
+        if (node->is_sink)
+        {
+            self->sink_events[num_sinks++] = self->events[i];
+        }
+    }
+
+    if (num_sinks == 1)
+    {
+        *replay_done = self->sink_events[0];
+        ret = clRetainEvent(*replay_done);
+    }
+    else
+    {
+        ret = clEnqueueMarkerWithWaitList(
+                self->nodes[self->num_nodes - 1].queue, num_sinks,
+                self->sink_events, replay_done);
+    }
+
+    Release_Events(self->events, self->num_nodes);
+
+    return ret;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Graph
+ *
+ * This function releases OpenCL objects & frees allocated memory.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Destroy' is defined to point on this function
+
+ * @return CL_SUCCESS always
+ */
+static ret_code Graph_Destroy(scow_Graph *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    if (self->last_replay)
+    {
+        clReleaseEvent(self->last_replay);
+    }
+
+#ifdef cl_khr_command_buffer
+    if (self->cmd_buf)
+    {
+        Destroy_Graph_Cmd_Buf((Graph_Cmd_Buf*) self->cmd_buf);
+    }
+#endif
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    free(self->sink_events);
+    free(self->events);
+    free(self->nodes);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function records kernel execution. ND sizes are taken from kernel at
+ * recording, arguments - at replay.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Add_Kernel' is defined to point on this function
+ * @param[in] kernel kernel with ND sizes set.
+ * @param[in] queue OpenCL command queue, that will be used for kernel execution
+ * @param[in] num_deps number of nodes, which must be finished before kernel
+ * execution.
+ * @param[in] deps array of ids of such nodes. Pass NULL, if there are none.
+ * @param[out] node_id id of recorded node. This argument is optional.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Add_Kernel(scow_Graph *self, scow_Kernel *kernel,
+        cl_command_queue queue, cl_uint num_deps, const cl_uint *deps,
+        cl_uint *node_id)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(kernel, INVALID_BUFFER_GIVEN);
+
+    if (kernel->Dimensionality == 0)
+    {
+        return INVALID_ND_DIMENSIONALITY;
+    }
+
+    Graph_Node node;
+    memset(&node, 0, sizeof(node));
+
+    node.type = GRAPH_NODE_KERNEL;
+    node.queue = queue;
+    node.kernel = kernel;
+    node.work_dim = (cl_uint) kernel->Dimensionality;
+
+    for (cl_uint i = 0; i < node.work_dim; i++)
+    {
+        node.global_size[i] = kernel->Global_Work_Size[i];
+        node.local_size[i] = kernel->Local_Work_Size[i];
+        node.has_local_size = node.has_local_size || node.local_size[i];
+    }
+
+    Set_Node_Deps(&node, num_deps, deps);
+
+    return Add_Node(self, &node, node_id);
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function records non-blocking transfer of whole buffer from Host to
+ * Device.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Add_Write' is defined to point on this function
+ * @param[in] mem_obj destination buffer.
+ * @param[in] queue OpenCL command queue, that will be used for transfer.
+ * @param[in] host_ptr source Host memory. It may be changed later by
+ * 'Set_Host_Ptr' function pointer.
+ * @param[in] num_deps number of nodes, which must be finished before transfer.
+ * @param[in] deps array of ids of such nodes. Pass NULL, if there are none.
+ * @param[out] node_id id of recorded node. This argument is optional.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Add_Write(scow_Graph *self, scow_Mem_Object *mem_obj,
+        cl_command_queue queue, const void *host_ptr, cl_uint num_deps,
+        const cl_uint *deps, cl_uint *node_id)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(mem_obj, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(host_ptr, INVALID_BUFFER_GIVEN);
+
+    if (mem_obj->obj_mem_type != BUFFER)
+    {
+        return INVALID_ARG_TYPE;
+    }
+
+    Graph_Node node;
+    memset(&node, 0, sizeof(node));
+
+    node.type = GRAPH_NODE_WRITE;
+    node.queue = queue;
+    node.mem_obj = mem_obj;
+    node.host_ptr = (void*) host_ptr;
+
+    Set_Node_Deps(&node, num_deps, deps);
+
+    return Add_Node(self, &node, node_id);
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function records non-blocking transfer of whole buffer from Device to
+ * Host.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Add_Read' is defined to point on this function
+ * @param[in] mem_obj source buffer.
+ * @param[in] queue OpenCL command queue, that will be used for transfer.
+ * @param[out] host_ptr destination Host memory. It may be changed later by
+ * 'Set_Host_Ptr' function pointer.
+ * @param[in] num_deps number of nodes, which must be finished before transfer.
+ * @param[in] deps array of ids of such nodes. Pass NULL, if there are none.
+ * @param[out] node_id id of recorded node. This argument is optional.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Add_Read(scow_Graph *self, scow_Mem_Object *mem_obj,
+        cl_command_queue queue, void *host_ptr, cl_uint num_deps,
+        const cl_uint *deps, cl_uint *node_id)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(mem_obj, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(host_ptr, INVALID_BUFFER_GIVEN);
+
+    if (mem_obj->obj_mem_type != BUFFER)
+    {
+        return INVALID_ARG_TYPE;
+    }
+
+    Graph_Node node;
+    memset(&node, 0, sizeof(node));
+
+    node.type = GRAPH_NODE_READ;
+    node.queue = queue;
+    node.mem_obj = mem_obj;
+    node.host_ptr = host_ptr;
+
+    Set_Node_Deps(&node, num_deps, deps);
+
+    return Add_Node(self, &node, node_id);
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function records copy of whole buffer into another one.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Add_Copy' is defined to point on this function
+ * @param[in] src source buffer.
+ * @param[out] dest destination buffer, which is not smaller than source one.
+ * @param[in] queue OpenCL command queue, that will be used for copy.
+ * @param[in] num_deps number of nodes, which must be finished before copy.
+ * @param[in] deps array of ids of such nodes. Pass NULL, if there are none.
+ * @param[out] node_id id of recorded node. This argument is optional.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Add_Copy(scow_Graph *self, scow_Mem_Object *src,
+        scow_Mem_Object *dest, cl_command_queue queue, cl_uint num_deps,
+        const cl_uint *deps, cl_uint *node_id)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(src, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
+
+    if (src->obj_mem_type != BUFFER || dest->obj_mem_type != BUFFER)
+    {
+        return DISTINCT_MEM_OBJECTS;
+    }
+
+    if (src->size > dest->size)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    Graph_Node node;
+    memset(&node, 0, sizeof(node));
+
+    node.type = GRAPH_NODE_COPY;
+    node.queue = queue;
+    node.mem_obj = src;
+    node.dest = dest;
+
+    Set_Node_Deps(&node, num_deps, deps);
+
+    return Add_Node(self, &node, node_id);
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function changes Host pointer of recorded transfer.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Set_Host_Ptr' is defined to point on this function
+ * @param[in] node_id id of transfer node.
+ * @param[in] host_ptr new Host pointer, which is used since next replay.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Set_Host_Ptr(scow_Graph *self, cl_uint node_id,
+        void *host_ptr)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(host_ptr, INVALID_BUFFER_GIVEN);
+
+    if (node_id >= self->num_nodes)
+    {
+        return VALUE_OUT_OF_RANGE;
+    }
+
+    Graph_Node *node = &self->nodes[node_id];
+
+    if (node->type != GRAPH_NODE_WRITE && node->type != GRAPH_NODE_READ)
+    {
+        return INVALID_ARG_TYPE;
+    }
+
+    node->host_ptr = host_ptr;
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function closes graph for recording & prepares it for replay.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Finalize' is defined to point on this function
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Finalize(scow_Graph *self)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    if (self->is_finalized)
+    {
+        return CL_SUCCESS;
+    }
+
+    if (self->num_nodes == 0)
+    {
+        return OBJECT_DOESNT_EXIST;
+    }
+
+    self->events = (cl_event*) calloc(self->num_nodes, sizeof(*self->events));
+    self->sink_events = (cl_event*) calloc(self->num_nodes,
+            sizeof(*self->sink_events));
+
+    if (!self->events || !self->sink_events)
+    {
+        free(self->events);
+        free(self->sink_events);
+        self->events = self->sink_events = NULL;
+
+        return BUFFER_NOT_ALLOCATED;
+    }
+
+    for (cl_uint i = 0; i < self->num_nodes; i++)
+    {
+        self->nodes[i].is_sink = CL_TRUE;
+    }
+
+    for (cl_uint i = 0; i < self->num_nodes; i++)
+    {
+        for (cl_uint j = 0; j < self->nodes[i].num_deps; j++)
+        {
+            self->nodes[self->nodes[i].deps[j]].is_sink = CL_FALSE;
+        }
+    }
+
+#ifdef cl_khr_command_buffer
+    cl_bool single_queue_kernels = CL_TRUE;
+
+    for (cl_uint i = 0; i < self->num_nodes; i++)
+    {
+        single_queue_kernels = single_queue_kernels
+                && (self->nodes[i].type == GRAPH_NODE_KERNEL)
+                && (self->nodes[i].queue == self->nodes[0].queue);
+    }
+
+    // Command buffer is recorded at first replay, when arguments are bound
+    if (single_queue_kernels)
+    {
+        self->cmd_buf = Make_Graph_Cmd_Buf(self);
+        self->use_cmd_buf = (self->cmd_buf != NULL);
+    }
+#endif
+
+    self->is_finalized = CL_TRUE;
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function enqueues all recorded commands.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Graph', in which
+ * function pointer 'Replay' is defined to point on this function
+ * @param[in] evt_wait_list_size Size of list of OpenCL events, that must be
+ * finished before graph execution. If graph doesn't need to wait for any
+ * events, pass 0 as argument.
+ * @param[in] evt_wait_list Pointer to array of OpenCL events. If graph doesn't
+ * need to wait for any events, pass NULL as argument.
+ * @param[out] generated_evt Pointer to OpenCL event, which is complete when all
+ * recorded commands are complete. If it isn't needed, pass NULL as argument.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Graph_Replay(scow_Graph *self, cl_uint evt_wait_list_size,
+        const cl_event *evt_wait_list, cl_event *generated_evt)
+{
+    cl_int ret = CL_SUCCESS;
+    cl_event replay_done = NULL;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    if (!self->is_finalized)
+    {
+        ret = self->Finalize(self);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    }
+
+    cl_bool replayed = CL_FALSE;
+
+#ifdef cl_khr_command_buffer
+    if (self->use_cmd_buf)
+    {
+        Graph_Cmd_Buf *cb = (Graph_Cmd_Buf*) self->cmd_buf;
+        cl_int last_status = CL_COMPLETE;
+
+        if (self->last_replay)
+        {
+            clGetEventInfo(self->last_replay, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                    sizeof(last_status), &last_status, NULL);
+        }
+
+        cl_bool needs_record = !cb->cmd_buf;
+
+        for (cl_uint i = 0; i < self->num_nodes && !needs_record; i++)
+        {
+            needs_record = (self->nodes[i].kernel->bind_generation !=
+                    self->nodes[i].recorded_generation);
+        }
+
+        /* Command buffer can't be enqueued while it's still pending, so enqueue
+         * commands one by one in this case. */
+        if (last_status == CL_COMPLETE)
+        {
+            if (needs_record)
+            {
+                ret = Record_Graph_Cmd_Buf(self);
+            }
+
+            if (ret == CL_SUCCESS)
+            {
+                ret = cb->Enqueue(1, &self->nodes[0].queue, cb->cmd_buf,
+                        evt_wait_list_size, evt_wait_list, &replay_done);
+            }
+
+            // Runtime rejects command buffer, so never use it again
+            if (ret != CL_SUCCESS)
+            {
+                Destroy_Graph_Cmd_Buf(cb);
+                self->cmd_buf = NULL;
+                self->use_cmd_buf = CL_FALSE;
+            }
+            else
+            {
+                replayed = CL_TRUE;
+            }
+        }
+    }
+#endif
+
+    if (!replayed)
+    {
+        ret = Replay_Nodes(self, evt_wait_list_size, evt_wait_list,
+                &replay_done);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    }
+
+    if (self->last_replay)
+    {
+        clReleaseEvent(self->last_replay);
+    }
+
+    self->last_replay = replay_done;
+
+    if (generated_evt)
+    {
+        clRetainEvent(replay_done);
+        *generated_evt = replay_done;
+    }
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Graph
+ *
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives Device,
+ * queues, etc.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_GRAPH_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. Kernels & memory objects, recorded in graph, must outlive it.
+ */
+scow_Graph* Make_Graph(scow_Steel_Thread *parent_steel_thread)
+{
+    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_GRAPH_PTR);
+
+    scow_Graph *self = (scow_Graph*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_GRAPH_PTR);
+
+    self->Destroy = Graph_Destroy;
+    self->Add_Kernel = Graph_Add_Kernel;
+    self->Add_Write = Graph_Add_Write;
+    self->Add_Read = Graph_Add_Read;
+    self->Add_Copy = Graph_Add_Copy;
+    self->Set_Host_Ptr = Graph_Set_Host_Ptr;
+    self->Finalize = Graph_Finalize;
+    self->Replay = Graph_Replay;
+
+    self->parent_steel_thread = parent_steel_thread;
+    self->error = Make_Error();
+
+    return self;
+}
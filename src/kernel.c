@@ -23,29 +23,25 @@
 #include "steel_thread.h"
 #include "device.h"
 #include "kernel.h"
+#include "program.h"
+#include "program_cache.h"
+#include "slab.h"
 
 /*! \cond PRIVATE */
-static cl_double Gather_Time_uS(cl_event* event)
-{
-    cl_ulong start = 0, end = 0;
-    cl_double no_time = -1.0;
-    cl_int ret = CL_SUCCESS;
-
-    OCL_CHECK_EXISTENCE(event, no_time);
+#undef AUTOTUNE_MAX_CANDIDATES
+#define AUTOTUNE_MAX_CANDIDATES     32
 
-    ret = clWaitForEvents(1, event);
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, no_time);
+// Number of timed runs per candidate, the first one is warm-up & isn't counted
+#undef AUTOTUNE_NUM_RUNS
+#define AUTOTUNE_NUM_RUNS           4
 
-    ret = clGetEventProfilingInfo(*event, CL_PROFILING_COMMAND_START,
-            sizeof(cl_ulong), &start, NULL);
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, no_time);
+// Local size is chosen among all candidates, if it isn't benchmarked
+#undef AUTO_MAX_CANDIDATES
+#define AUTO_MAX_CANDIDATES         512
 
-    ret = clGetEventProfilingInfo(*event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong),
-            &end, NULL);
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, no_time);
-
-    return (cl_double) (end - start) * (cl_double) (1e-03);
-}
+// The largest local work group size, that is chosen without benchmarking
+#undef AUTO_TARGET_WG_SIZE
+#define AUTO_TARGET_WG_SIZE         256
 
 static cl_uint Get_Args_Num(scow_Kernel* minimal_kernel)
 {
@@ -62,53 +58,415 @@ static cl_uint Get_Args_Num(scow_Kernel* minimal_kernel)
     return num_args;
 }
 
-static char* Read_Source_File(const char *filename)
+/* Resources, that kernel needs on Device of parent Steel Thread, are queried
+ * once, when OpenCL kernel is created. */
+static ret_code Query_Kernel_Info(scow_Kernel* self)
 {
-    long int size = 0, res = 0;
+    cl_device_id device_id = self->parent_steel_thread->device->device_id;
 
-    char *src = NULL;
+    self->num_args = Get_Args_Num(self);
 
-    FILE *file = fopen(filename, "rb");
+    cl_int ret = clGetKernelWorkGroupInfo(self->kernel, device_id,
+            CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &self->work_group_size,
+            NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    if (!file)
-        return NULL;
+    ret = clGetKernelWorkGroupInfo(self->kernel, device_id,
+            CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(size_t),
+            &self->preferred_wg_size_multiple, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    if (fseek(file, 0, SEEK_END))
+    if (self->preferred_wg_size_multiple == 0)
     {
-        fclose(file);
-        return NULL;
+        self->preferred_wg_size_multiple = 1;
     }
 
-    size = ftell(file);
-    if (size == 0)
+    ret = clGetKernelWorkGroupInfo(self->kernel, device_id,
+            CL_KERNEL_LOCAL_MEM_SIZE, sizeof(cl_ulong), &self->local_mem_size,
+            NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    ret = clGetKernelWorkGroupInfo(self->kernel, device_id,
+            CL_KERNEL_PRIVATE_MEM_SIZE, sizeof(cl_ulong),
+            &self->private_mem_size, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    return CL_SUCCESS;
+}
+
+// Real extent of padded ND range is passed as the last argument by wrapper
+static size_t Get_User_Args_Num(scow_Kernel* self)
+{
+    return self->pad_global_size ? self->num_args - 1 : self->num_args;
+}
+
+/* Kernel, made from program which is built asynchronously, gets OpenCL kernel
+ * at first use. Only build of its own program is waited for. */
+static ret_code Kernel_Wait_Ready(scow_Kernel* self)
+{
+    cl_int ret;
+
+    if (self->kernel)
     {
-        fclose(file);
-        return NULL;
+        return CL_SUCCESS;
+    }
+
+    ret = self->parent_program->Wait_Build(self->parent_program);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->program = self->parent_program->program;
+    self->kernel = clCreateKernel(self->program, self->name, &ret);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    return Query_Kernel_Info(self);
+}
+
+// Pass arguments, changed since last enqueue, to OpenCL kernel
+static ret_code Flush_Arg_Bindings(scow_Kernel* self)
+{
+    cl_int ret;
+
+    for (cl_uint i = 0; i < self->num_arg_bindings; i++)
+    {
+        Kernel_Arg_Binding* binding = &self->arg_bindings[i];
+
+        if (!binding->is_dirty)
+        {
+            continue;
+        }
+
+        ret = clSetKernelArg(self->kernel, i, binding->size, binding->value);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+        binding->is_dirty = CL_FALSE;
+    }
+
+    return CL_SUCCESS;
+}
+
+static int Local_Size_Fits(scow_Kernel* self, const size_t* local_size,
+        size_t max_wg_size)
+{
+    size_t wg_size = 1;
+
+    // All zero sizes mean, that local size is left to OpenCL runtime
+    if (local_size[0] == 0)
+    {
+        return 1;
+    }
+
+    for (size_t i = 0; i < self->Dimensionality; i++)
+    {
+        if (local_size[i] == 0 || self->Global_Work_Size[i] % local_size[i])
+        {
+            return 0;
+        }
+
+        wg_size *= local_size[i];
+    }
+
+    return wg_size <= max_wg_size;
+}
+
+/* Candidates are power of two sizes, which divide global size, have total
+ * size multiple to preferred one & give work groups enough to load all
+ * compute units. The last requirement is dropped, if nothing satisfies it.
+ * Candidates are ranked by total size, the largest first, & by size along
+ * the fastest dimension, the widest first, so that the cap on their number
+ * cuts off only small work groups. */
+static cl_uint Get_Local_Size_Candidates(scow_Kernel* self,
+        size_t max_wg_size, size_t wg_size_multiple,
+        size_t candidates[][MAX_NUM_DIMENSIONS], cl_uint max_candidates)
+{
+    size_t sizes[MAX_NUM_DIMENSIONS][8 * sizeof(size_t)];
+    cl_uint num_sizes[MAX_NUM_DIMENSIONS], num_candidates = 0;
+    size_t min_num_groups =
+            self->parent_steel_thread->device->max_compute_units;
+    size_t top_wg_size = 1;
+
+    for (size_t d = 0; d < MAX_NUM_DIMENSIONS; d++)
+    {
+        num_sizes[d] = 0;
+
+        if (d >= self->Dimensionality)
+        {
+            sizes[d][num_sizes[d]++] = 1;
+            continue;
+        }
+
+        for (size_t p = 1; p <= max_wg_size && p <= self->Global_Work_Size[d];
+                p <<= 1)
+        {
+            if (self->Global_Work_Size[d] % p == 0)
+            {
+                sizes[d][num_sizes[d]++] = p;
+            }
+        }
+    }
+
+    while (top_wg_size <= max_wg_size / 2)
+    {
+        top_wg_size <<= 1;
+    }
+
+    for (int relaxed = 0; relaxed < 2 && num_candidates == 0; relaxed++)
+    {
+        for (size_t wg_size = top_wg_size;
+                wg_size > 0 && num_candidates < max_candidates; wg_size >>= 1)
+        {
+            if (wg_size % wg_size_multiple)
+            {
+                continue;
+            }
+
+            for (cl_uint i = num_sizes[0]; i-- > 0;)
+            for (cl_uint j = num_sizes[1]; j-- > 0;)
+            for (cl_uint k = num_sizes[2]; k-- > 0;)
+            {
+                size_t local[MAX_NUM_DIMENSIONS] =
+                        { sizes[0][i], sizes[1][j], sizes[2][k] };
+                size_t num_groups = 1;
+
+                for (size_t d = 0; d < self->Dimensionality; d++)
+                {
+                    num_groups *= self->Global_Work_Size[d] / local[d];
+                }
+
+                if (local[0] * local[1] * local[2] != wg_size
+                        || (!relaxed && num_groups < min_num_groups)
+                        || num_candidates == max_candidates)
+                {
+                    continue;
+                }
+
+                memcpy(candidates[num_candidates++], local, sizeof(local));
+            }
+        }
+    }
+
+    return num_candidates;
+}
+
+// Best run time of kernel with given local size, negative value on fail
+static cl_double Time_Local_Size(scow_Kernel* self, cl_command_queue* queue,
+        const size_t* local_size)
+{
+    cl_double best_time = -1.0;
+
+    for (int run = 0; run < AUTOTUNE_NUM_RUNS; run++)
+    {
+        cl_event event;
+
+        cl_int ret = clEnqueueNDRangeKernel(*queue, self->kernel,
+                self->Dimensionality, NULL, self->Global_Work_Size, local_size,
+                0, NULL, &event);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, -1.0);
+
+        cl_double run_time = Gather_Time_uS(&event);
+        clReleaseEvent(event);
+
+        if (run_time < 0.0)
+        {
+            return -1.0;
+        }
+
+        if (run > 0 && (best_time < 0.0 || run_time < best_time))
+        {
+            best_time = run_time;
+        }
+    }
+
+    return best_time;
+}
+
+/* Look up local size in tuning database. If it's not there, benchmark
+ * candidates & store the fastest one. Local size left to OpenCL runtime takes
+ * part in competition too. */
+static ret_code Autotune_Local_Size(scow_Kernel* self, cl_command_queue* queue)
+{
+    size_t max_wg_size = self->work_group_size,
+            wg_size_multiple = self->preferred_wg_size_multiple;
+    size_t best_local[MAX_NUM_DIMENSIONS] = { 0, 0, 0 };
+    size_t candidates[AUTOTUNE_MAX_CANDIDATES][MAX_NUM_DIMENSIONS];
+
+    ret_code ret = Load_Tuned_Local_Size(self->parent_steel_thread, self->name,
+            self->Dimensionality, self->Global_Work_Size, best_local);
+
+    if (ret == CL_SUCCESS && Local_Size_Fits(self, best_local, max_wg_size))
+    {
+        memcpy(self->Local_Work_Size, best_local, sizeof(best_local));
+        return CL_SUCCESS;
+    }
+
+    memset(best_local, 0, sizeof(best_local));
+    cl_double best_time = Time_Local_Size(self, queue, NULL);
+
+    cl_uint num_candidates = Get_Local_Size_Candidates(self, max_wg_size,
+            wg_size_multiple, candidates, AUTOTUNE_MAX_CANDIDATES);
+
+    for (cl_uint i = 0; i < num_candidates; i++)
+    {
+        cl_double run_time = Time_Local_Size(self, queue, candidates[i]);
+
+        if (run_time >= 0.0 && (best_time < 0.0 || run_time < best_time))
+        {
+            best_time = run_time;
+            memcpy(best_local, candidates[i], sizeof(best_local));
+        }
+    }
+
+    // Nothing could be timed (e. g. queue without profiling), so keep default
+    if (best_time < 0.0)
+    {
+        return CANT_SET_ND_SIZE;
+    }
+
+    memcpy(self->Local_Work_Size, best_local, sizeof(best_local));
+
+    // Failure to store only costs tuning at next run
+    Store_Tuned_Local_Size(self->parent_steel_thread, self->name,
+            self->Dimensionality, self->Global_Work_Size, best_local);
+
+    return CL_SUCCESS;
+}
+
+/* Local size is chosen by kernel resources & Device properties. The best
+ * candidate:
+ *   - has row of work items, which covers whole cache line of 4-byte elements,
+ *     so that neighbour work items access memory coalesced
+ *   - gives at least two work groups per compute unit to hide latency
+ *   - is the largest one, which doesn't exceed target size. Target size is
+ *     halved for kernels, which use local or private memory, so that more
+ *     work groups fit into compute unit at once. */
+static cl_bool Choose_Local_Size(scow_Kernel* self, size_t* local_size)
+{
+    size_t candidates[AUTO_MAX_CANDIDATES][MAX_NUM_DIMENSIONS];
+    scow_Device* device = self->parent_steel_thread->device;
+
+    cl_uint num_candidates = Get_Local_Size_Candidates(self,
+            self->work_group_size, self->preferred_wg_size_multiple,
+            candidates, AUTO_MAX_CANDIDATES);
+
+    if (num_candidates == 0)
+    {
+        return CL_FALSE;
+    }
+
+    size_t row_size = device->global_mem_cacheline_size / sizeof(cl_float);
+    size_t target_size = (self->work_group_size < AUTO_TARGET_WG_SIZE) ?
+            self->work_group_size : AUTO_TARGET_WG_SIZE;
+
+    if (self->local_mem_size || self->private_mem_size)
+    {
+        target_size /= 2;
+    }
+
+    if (target_size < self->preferred_wg_size_multiple)
+    {
+        target_size = self->preferred_wg_size_multiple;
+    }
+
+    int best_score = -1;
+    size_t best_wg_size = 0;
+
+    for (cl_uint i = 0; i < num_candidates; i++)
+    {
+        size_t* local = candidates[i];
+        size_t wg_size = local[0] * local[1] * local[2], num_groups = 1;
+
+        for (size_t d = 0; d < self->Dimensionality; d++)
+        {
+            num_groups *= self->Global_Work_Size[d] / local[d];
+        }
+
+        int score = 0;
+
+        if (local[0] >= row_size || local[0] == self->Global_Work_Size[0])
+        {
+            score += 4;
+        }
+        if (num_groups >= 2 * (size_t) device->max_compute_units)
+        {
+            score += 2;
+        }
+        if (wg_size <= target_size)
+        {
+            score += 1;
+        }
+
+        // Same score means, that both sizes are on the same side of target
+        int is_better = (score > best_score) || (score == best_score
+                && ((wg_size <= target_size) ?
+                        wg_size > best_wg_size : wg_size < best_wg_size));
+
+        if (is_better)
+        {
+            best_score = score;
+            best_wg_size = wg_size;
+            memcpy(local_size, local, MAX_NUM_DIMENSIONS * sizeof(size_t));
+        }
     }
 
-    rewind(file);
+    return CL_TRUE;
+}
+
+// Make kernel ready & pass it arguments & ND sizes before enqueue
+static ret_code Prepare_ND_Range(scow_Kernel* self, cl_command_queue* queue)
+{
+    cl_int ret;
+
+    ret = Kernel_Wait_Ready(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    src = (char *) calloc(size + 1, sizeof(char));
-    if (!src)
+    // Local size, set before kernel was ready, is checked only now
+    if (!Local_Size_Fits(self, self->Local_Work_Size, self->work_group_size))
     {
-        src = NULL;
-        fclose(file);
-        return src;
+        OCL_DIE_ON_ERROR(INVALID_LOCAL_WG_SIZE, CL_SUCCESS, NULL,
+                INVALID_LOCAL_WG_SIZE);
     }
 
-    res = fread(src, 1, sizeof(char) * size, file);
-    if (res != sizeof(char) * size)
+    ret = Flush_Arg_Bindings(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    // Tuning is done once, local size is left to OpenCL runtime if it fails
+    if (self->autotune_local_size)
     {
-        fclose(file);
-        free(src);
+        self->autotune_local_size = CL_FALSE;
+        Autotune_Local_Size(self, queue);
+    }
+
+    return CL_SUCCESS;
+}
 
-        return (char*)NULL;
+// Local size to pass to OpenCL, NULL if it's left to OpenCL runtime
+static size_t* Get_Local_Size(scow_Kernel* self)
+{
+    for (size_t i = 0; i < self->Dimensionality; i++)
+    {
+        if (self->Local_Work_Size[i] != 0)
+        {
+            return &self->Local_Work_Size[0];
+        }
     }
 
-    src[size] = '\0'; /* NULL terminated */
-    fclose(file);
+    return NULL;
+}
+
+/* Chunks are made along the slowest (last) dimension & consist of whole work
+ * groups. Work groups are spread evenly, so chunks differ by one group max. */
+static void Get_Chunk_Range(scow_Kernel* self, size_t num_chunks,
+        size_t chunk_index, size_t* offset, size_t* size)
+{
+    size_t last_dim = self->Dimensionality - 1;
+    size_t group_size = self->Local_Work_Size[last_dim] ?
+            self->Local_Work_Size[last_dim] : 1;
+    size_t num_groups = self->Global_Work_Size[last_dim] / group_size;
+
+    size_t first_group = num_groups * chunk_index / num_chunks;
+    size_t last_group = num_groups * (chunk_index + 1) / num_chunks;
 
-    return src;
+    *offset = first_group * group_size;
+    *size = (last_group - first_group) * group_size;
 }
 /*! \endcond */
 
@@ -130,21 +488,25 @@ static ret_code Kernel_Destroy(scow_Kernel* self)
     {
         clReleaseKernel(self->kernel);
     }
-    if (self->program)
+    for (cl_uint i = 0; i < self->num_arg_bindings; i++)
     {
-        clReleaseProgram(self->program);
+        free(self->arg_bindings[i].value);
     }
+    free(self->arg_bindings);
 
-    if (self->timer)
-    {
-        self->timer->Destroy(self->timer);
-    }
-    if (self->error)
+    // Program is released only when all its kernels are destroyed
+    if (self->parent_program)
     {
-        self->error->Destroy(self->error);
+        __atomic_sub_fetch(&self->parent_program->num_kernels, 1,
+                __ATOMIC_RELAXED);
+        self->parent_program->Destroy(self->parent_program);
     }
 
-    free(self);
+    self->timer->Destroy(self->timer);
+    self->error->Destroy(self->error);
+
+    self->parent_steel_thread->kernel_slab->Free(
+            self->parent_steel_thread->kernel_slab, self);
 
     return CL_SUCCESS;
 }
@@ -152,220 +514,677 @@ static ret_code Kernel_Destroy(scow_Kernel* self)
 /**
  * \related cl_Kernel
  *
- * This function sets argument for OpenCL kernel
+ * This function binds argument for OpenCL kernel. Argument value is copied, so
+ * it may be changed right after call. It's passed to OpenCL kernel at next
+ * enqueue, only if it differs from value passed at previous one.
  *
  * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
- * function pointer 'Set_Arg' is defined to point on this function
+ * function pointer 'Bind_Arg' is defined to point on this function
  * @param[in] arg_index number of kernel argument
  * @param[in] arg_size size of kernel argument
- * @param[in] ptr_to_arg pointer to argument
+ * @param[in] ptr_to_arg pointer to argument. Pass NULL for argument in local
+ * memory.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Bind_Arg(scow_Kernel* self, const cl_uint arg_index,
+        const size_t arg_size, const void* ptr_to_arg)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    if (arg_size == 0)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    // Kernel may be not ready yet, so number of arguments isn't known
+    if (arg_index >= self->num_arg_bindings)
+    {
+        Kernel_Arg_Binding* bindings = (Kernel_Arg_Binding*) realloc(
+                self->arg_bindings, (arg_index + 1) * sizeof(*bindings));
+        OCL_CHECK_EXISTENCE(bindings, BUFFER_NOT_ALLOCATED);
+
+        memset(bindings + self->num_arg_bindings, 0,
+                (arg_index + 1 - self->num_arg_bindings) * sizeof(*bindings));
+
+        self->arg_bindings = bindings;
+        self->num_arg_bindings = arg_index + 1;
+    }
+
+    Kernel_Arg_Binding* binding = &self->arg_bindings[arg_index];
+
+    int same_value = binding->is_bound && (binding->size == arg_size)
+            && ((binding->value == NULL) == (ptr_to_arg == NULL))
+            && (!ptr_to_arg || !memcmp(binding->value, ptr_to_arg, arg_size));
+
+    if (same_value)
+    {
+        return CL_SUCCESS;
+    }
+
+    if (!ptr_to_arg)
+    {
+        free(binding->value);
+        binding->value = NULL;
+    }
+    else
+    {
+        if (!binding->value || binding->size != arg_size)
+        {
+            void* value = realloc(binding->value, arg_size);
+            OCL_CHECK_EXISTENCE(value, BUFFER_NOT_ALLOCATED);
+
+            binding->value = value;
+        }
+
+        memcpy(binding->value, ptr_to_arg, arg_size);
+    }
+
+    binding->size = arg_size;
+    binding->is_bound = CL_TRUE;
+    binding->is_dirty = CL_TRUE;
+
+    self->bind_generation++;
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function sets ND dimensions for OpenCL kernel
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Set_ND_Sizes' is defined to point on this function
+ * @param[in] dimensionality number of problem's dimensions
+ * @param[in] global_wg_size Global amount of work items in each dimension
+ * @param[in] local_wg_size Size of local work group (if any) in each dimension.
+ * This argument is optional. If kernel doesn't utilize local work groups,
+ * pass NULL pointer as argument.
 
  * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ * If program of kernel is still built asynchronously, function doesn't wait for
+ * it & local size is checked against maximal one at enqueue.
  *
  * @see cl_err_codes.h for details
  * @see description of structure 'cl_Error_t' for details about error handling
  */
-static ret_code Kernel_Set_Arg(scow_Kernel* self, const cl_uint arg_index,
-        const size_t arg_size, void* ptr_to_arg)
+static ret_code Kernel_Set_ND_Sizes(scow_Kernel* self,
+        const unsigned int dimensionality, const unsigned int* global_wg_size,
+        const unsigned int* local_wg_size)
+{
+    size_t curr_local_wg_size;
+
+    // Local work groups are not mandatory
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(global_wg_size, INVALID_BUFFER_GIVEN);
+
+    if (dimensionality <= MAX_NUM_DIMENSIONS)
+    {
+        self->Dimensionality = dimensionality;
+    }
+    else
+    {
+        return INVALID_ND_DIMENSIONALITY;
+    }
+
+    // Sizes, given before, must not affect new ones
+    self->autotune_local_size = CL_FALSE;
+    self->pad_global_size = CL_FALSE;
+    memset(self->Local_Work_Size, 0, sizeof(self->Local_Work_Size));
+    memset(self->Real_Work_Size, 0, sizeof(self->Real_Work_Size));
+
+    for (int i = 0; i < self->Dimensionality; i++)
+    {
+        /* If local work groups are present, compute current local work group
+         * size & compare it with maximal available.
+         */
+        if (local_wg_size)
+        {
+            (i == 0) ?
+                    (curr_local_wg_size = local_wg_size[i]) :
+                    (curr_local_wg_size *= local_wg_size[i]);
+
+            /* Maximal local work group size is known, when kernel is ready.
+             * Otherwise local size is checked at enqueue, not to wait for
+             * asynchronous build here. */
+            int good_local_size = !self->kernel ||
+                    curr_local_wg_size <= self->work_group_size;
+
+            if (good_local_size)
+            {
+                self->Local_Work_Size[i] = local_wg_size[i];
+            }
+            else
+            {
+                OCL_DIE_ON_ERROR(INVALID_LOCAL_WG_SIZE, CL_SUCCESS, NULL,
+                        INVALID_LOCAL_WG_SIZE);
+            }
+        }
+
+        /* Check that given global work group size is  multiple to corresponded
+         * local work group size.
+         */
+        int good_global_size = 1;
+
+        if (local_wg_size)
+        {
+            good_global_size = (global_wg_size[i] % local_wg_size[i] == 0);
+        }
+
+        if (good_global_size)
+        {
+            self->Global_Work_Size[i] = global_wg_size[i];
+            self->Real_Work_Size[i] = global_wg_size[i];
+        }
+        else
+        {
+            OCL_DIE_ON_ERROR(GLOBAL_NOT_MULTIPLE_TO_LOCAL, CL_SUCCESS, NULL,
+                    GLOBAL_NOT_MULTIPLE_TO_LOCAL);
+        }
+    }
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function sets global ND dimensions for OpenCL kernel & turns on local
+ * work group size auto-tuning. Local size is looked up in tuning database of
+ * parent Steel Thread at next kernel enqueue. If it isn't found there, kernel
+ * is run with candidate local sizes & the fastest one is stored in database.
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Set_ND_Sizes_Autotune' is defined to point on this
+ * function
+ * @param[in] dimensionality number of problem's dimensions
+ * @param[in] global_wg_size Global amount of work items in each dimension
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @warning during tuning kernel is run several times in the queue, given at
+ * enqueue, so it must give same result when run repeatedly over its arguments.
+ * Queue must be created with profiling enabled, otherwise local size is left
+ * to OpenCL runtime.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Set_ND_Sizes_Autotune(scow_Kernel* self,
+        const unsigned int dimensionality, const unsigned int* global_wg_size)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    ret_code ret = Kernel_Set_ND_Sizes(self, dimensionality, global_wg_size,
+            NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->autotune_local_size = CL_TRUE;
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function sets global ND dimensions for OpenCL kernel & chooses local
+ * work group size by resources, kernel needs (queried at kernel creation), &
+ * by properties of Device, such as number of compute units & cache line size.
+ * Nothing is run on Device, so it's cheap alternative to auto-tuning.
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Set_ND_Sizes_Auto' is defined to point on this function
+ * @param[in] dimensionality Number of dimensions
+ * @param[in] global_wg_size Global amount of work items in each dimension
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ * If no local size fits global one, local size is left to OpenCL runtime.
+ *
+ * @warning if program of kernel is built asynchronously, function waits for
+ * build to complete.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Set_ND_Sizes_Auto(scow_Kernel* self,
+        const unsigned int dimensionality, const unsigned int* global_wg_size)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    ret_code ret = Kernel_Set_ND_Sizes(self, dimensionality, global_wg_size,
+            NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    // Resources of kernel are known only when it's ready
+    ret = Kernel_Wait_Ready(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    size_t local_size[MAX_NUM_DIMENSIONS];
+
+    if (Choose_Local_Size(self, local_size))
+    {
+        memcpy(self->Local_Work_Size, local_size, sizeof(local_size));
+    }
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function sets ND dimensions for OpenCL kernel, rounding global size up
+ * to multiple of local one in each dimension, so that well-shaped work groups
+ * can be used for any problem size.
+ *
+ * Real size is passed to kernel as its last argument of type uint4 (unused
+ * components are 1), which is bound automatically. Kernel must skip work items
+ * out of it, e. g. 'if (get_global_id(0) >= real_size.x) return;'. Other
+ * arguments are passed as usual, so launch functions expect one argument less.
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Set_ND_Sizes_Padded' is defined to point on this function
+ * @param[in] dimensionality Number of dimensions
+ * @param[in] global_wg_size Real amount of work items in each dimension
+ * @param[in] local_wg_size Local work group size in each dimension. Pass NULL
+ * to choose it like 'Set_ND_Sizes_Auto' does.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Set_ND_Sizes_Padded(scow_Kernel* self,
+        const unsigned int dimensionality, const unsigned int* global_wg_size,
+        const unsigned int* local_wg_size)
+{
+    unsigned int padded_size[MAX_NUM_DIMENSIONS], quantum[MAX_NUM_DIMENSIONS];
+    cl_uint real_size[4] = { 1, 1, 1, 1 };
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(global_wg_size, INVALID_BUFFER_GIVEN);
+
+    if (dimensionality == 0 || dimensionality > MAX_NUM_DIMENSIONS)
+    {
+        return INVALID_ND_DIMENSIONALITY;
+    }
+
+    ret_code ret = Kernel_Wait_Ready(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    // Kernel must have argument for real size
+    if (self->num_args == 0)
+    {
+        return ARG_NOT_FOUND;
+    }
+
+    /* Without local size, the fastest dimension is padded to preferred multiple,
+     * so that local size can be chosen among well-shaped ones. */
+    for (unsigned int i = 0; i < dimensionality; i++)
+    {
+        if (local_wg_size)
+        {
+            quantum[i] = local_wg_size[i];
+        }
+        else
+        {
+            quantum[i] = (i == 0) ?
+                    (unsigned int) self->preferred_wg_size_multiple : 1;
+        }
+
+        if (quantum[i] == 0)
+        {
+            return INVALID_LOCAL_WG_SIZE;
+        }
+
+        padded_size[i] = (global_wg_size[i] + quantum[i] - 1) / quantum[i]
+                * quantum[i];
+        real_size[i] = global_wg_size[i];
+    }
+
+    if (local_wg_size)
+    {
+        ret = Kernel_Set_ND_Sizes(self, dimensionality, padded_size,
+                local_wg_size);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    }
+    else
+    {
+        ret = Kernel_Set_ND_Sizes_Auto(self, dimensionality, padded_size);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    }
+
+    for (unsigned int i = 0; i < dimensionality; i++)
+    {
+        self->Real_Work_Size[i] = global_wg_size[i];
+    }
+
+    self->pad_global_size = CL_TRUE;
+
+    // Binding is passed to OpenCL kernel at next enqueue, if it's changed
+    return Kernel_Bind_Arg(self, self->num_args - 1, sizeof(real_size),
+            real_size);
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function enqueues kernel execution
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'ND_Range' is defined to point on this function
+ * @param[in] queue OpenCL command queue, that will be used for kernel execution
+ * @param[in] evt_wait_list_size Size of list of OpenCL events, that must be
+ * finished before kernel execution. If kernel doesn't need to wait for any
+ * events, pass 0 as argument.
+ * @param[in] evt_wait_list Pointer to array of OpenCL events. If kernel doesn't
+ * need to wait for any events, pass NULL as argument.
+ * @param[out] generated_evt Pointer to OpenCL event, that kernel will produce.
+ * If kernel doesn't need to produce any event, pass NULL as argument
+ * @param[in] time_measure_flag flag, that denotes if kernel execution time
+ * should be gathered.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_ND_Range(scow_Kernel* self, cl_command_queue* queue,
+        cl_uint evt_wait_list_size, const cl_event* evt_wait_list,
+        cl_event* generated_evt, TIME_STUDY_MODE time_measure_mode)
+{
+    cl_int ret;
+    cl_event* p_evt;
+
+    ret = Prepare_ND_Range(self, queue);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    if (generated_evt == NULL)
+    {
+        // Passing internal event to NDRange()
+        self->evt_check_priority = INTERNAL_EVT_PRIORITY;
+        p_evt = &self->internal_event;
+    }
+    else
+    {
+        // Passing external event to NDRange()
+        self->evt_check_priority = EXTERNAL_EVT_PRIORITY;
+        self->p_external_event = generated_evt;
+        p_evt = generated_evt;
+    }
+
+    ret = clEnqueueNDRangeKernel(*queue, self->kernel, self->Dimensionality,
+            NULL, self->Global_Work_Size, Get_Local_Size(self),
+            evt_wait_list_size, evt_wait_list, p_evt);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    return self->timer->Measure_Event(self->timer, p_evt, time_measure_mode);
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function binds arguments & enqueues kernel execution. Only arguments,
+ * changed since previous enqueue, are passed to OpenCL kernel.
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Launck' is defined to point on this function
+ * @param[in] queue OpenCL command queue, that will be used for kernel execution
+ * @param[in] evt_wait_list_size Size of list of OpenCL events, that must be
+ * finished before kernel execution. If kernel doesn't need to wait for any
+ * events, pass 0 as argument.
+ * @param[in] evt_wait_list Pointer to array of OpenCL events. If kernel doesn't
+ * need to wait for any events, pass NULL as argument.
+ * @param[out] generated_evt Pointer to OpenCL event, that kernel will produce.
+ * If kernel doesn't need to produce any event, pass NULL as argument
+ * @param[in] time_measure_flag flag, that denotes if kernel execution time
+ * should be gathered.
+ * @param[in] argument structure of type 'cl_Kernel_Arg_t', that describes
+ * OpenCL kernel arguments characteristics, such as size and pointer to argument.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Launch(scow_Kernel* self, cl_command_queue* queue,
+        cl_uint evt_wait_list_size, const cl_event* evt_wait_list,
+        cl_event* generated_evt, TIME_STUDY_MODE time_measure_mode, ...)
+{
+    va_list kernel_arguments;
+    cl_int ret;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    // Number of arguments is known only when kernel is ready
+    ret = Kernel_Wait_Ready(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    // Other function arguments are kernel arguments. They are optional
+    va_start(kernel_arguments, time_measure_mode);
+
+    for (int i = 0; i < Get_User_Args_Num(self); i++)
+    {
+        scow_Kernel_Arg curr_arg = va_arg(kernel_arguments, scow_Kernel_Arg);
+
+        ret = Kernel_Bind_Arg(self, i, curr_arg.size, curr_arg.ptr);
+
+        if (ret != CL_SUCCESS)
+        {
+            va_end(kernel_arguments);
+            OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+        }
+    }
+
+    va_end(kernel_arguments);
+
+    return Kernel_ND_Range(self, queue, evt_wait_list_size, evt_wait_list,
+            generated_evt, time_measure_mode);
+}
+
+/**
+ * \related cl_Kernel
+ *
+ * This function enqueues kernel execution with arguments, bound by 'Bind_Arg'
+ * function pointer or by previous launches.
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Launch_Bound' is defined to point on this function
+ * @param[in] queue OpenCL command queue, that will be used for kernel execution
+ * @param[in] evt_wait_list_size Size of list of OpenCL events, that must be
+ * finished before kernel execution. If kernel doesn't need to wait for any
+ * events, pass 0 as argument.
+ * @param[in] evt_wait_list Pointer to array of OpenCL events. If kernel doesn't
+ * need to wait for any events, pass NULL as argument.
+ * @param[out] generated_evt Pointer to OpenCL event, that kernel will produce.
+ * If kernel doesn't need to produce any event, pass NULL as argument
+ * @param[in] time_measure_flag flag, that denotes if kernel execution time
+ * should be gathered.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Launch_Bound(scow_Kernel* self, cl_command_queue* queue,
+        cl_uint evt_wait_list_size, const cl_event* evt_wait_list,
+        cl_event* generated_evt, TIME_STUDY_MODE time_measure_mode)
 {
-    return clSetKernelArg(self->kernel, arg_index, arg_size, ptr_to_arg);
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    return Kernel_ND_Range(self, queue, evt_wait_list_size, evt_wait_list,
+            generated_evt, time_measure_mode);
 }
 
 /**
  * \related cl_Kernel
  *
- * This function sets ND dimensions for OpenCL kernel
+ * This function gives part of ND range, which is processed by particular chunk
+ * of chunked launch. Chunks are made along the slowest (last) dimension & are
+ * aligned to local work group size, other dimensions are processed fully by
+ * each chunk.
  *
  * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
- * function pointer 'Set_ND_Sizes' is defined to point on this function
- * @param[in] dimensionality number of problem's dimensions
- * @param[in] global_wg_size Global amount of work items in each dimension
- * @param[in] local_wg_size Size of local work group (if any) in each dimension.
- * This argument is optional. If kernel doesn't utilize local work groups,
- * pass NULL pointer as argument.
+ * function pointer 'Get_Chunk' is defined to point on this function
+ * @param[in] num_chunks number of chunks, ND range is split into.
+ * @param[in] chunk_index index of chunk.
+ * @param[out] offset global offset of chunk in the slowest dimension.
+ * @param[out] size number of work items of chunk in the slowest dimension.
 
  * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
  *
+ * @warning if local size is auto-tuned, chunks are known only after first
+ * launch.
+ *
  * @see cl_err_codes.h for details
  * @see description of structure 'cl_Error_t' for details about error handling
  */
-static ret_code Kernel_Set_ND_Sizes(scow_Kernel* self,
-        const unsigned int dimensionality, const unsigned int* global_wg_size,
-        const unsigned int* local_wg_size)
+static ret_code Kernel_Get_Chunk(scow_Kernel* self, const cl_uint num_chunks,
+        const cl_uint chunk_index, size_t* offset, size_t* size)
 {
-    cl_int ret;
-
-    size_t max_available_local_wg_size, curr_local_wg_size;
-
-    // Local work groups are not mandatory
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(global_wg_size, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(offset, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(size, INVALID_BUFFER_GIVEN);
 
-    if (dimensionality <= MAX_NUM_DIMENSIONS)
-    {
-        self->Dimensionality = dimensionality;
-    }
-    else
+    if (self->Dimensionality == 0)
     {
-        return INVALID_ND_DIMENSIONALITY;
+        return CANT_SET_ND_SIZE;
     }
 
-    // Check what local work group size is maximal available for kernel.
-    ret = clGetKernelWorkGroupInfo(self->kernel,
-        self->parent_steel_thread->device->device_id,
-            CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t),
-            &max_available_local_wg_size,
-            NULL);
-
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    size_t last_dim = self->Dimensionality - 1;
+    size_t group_size = self->Local_Work_Size[last_dim] ?
+            self->Local_Work_Size[last_dim] : 1;
 
-    for (int i = 0; i < self->Dimensionality; i++)
+    // Each chunk must have at least one work group
+    if (num_chunks == 0 || chunk_index >= num_chunks
+            || num_chunks > self->Global_Work_Size[last_dim] / group_size)
     {
-        /* If local work groups are present, compute current local work group
-         * size & compare it with maximal available.
-         */
-        if (local_wg_size)
-        {
-            (i == 0) ?
-                    (curr_local_wg_size = local_wg_size[i]) :
-                    (curr_local_wg_size *= local_wg_size[i]);
-
-            int good_local_size = curr_local_wg_size
-                    <= max_available_local_wg_size;
-
-            if (good_local_size)
-            {
-                self->Local_Work_Size[i] = local_wg_size[i];
-            }
-            else
-            {
-                OCL_DIE_ON_ERROR(INVALID_LOCAL_WG_SIZE, CL_SUCCESS, NULL,
-                        INVALID_LOCAL_WG_SIZE);
-            }
-        }
-
-        /* Check that given global work group size is  multiple to corresponded
-         * local work group size.
-         */
-        int good_global_size = 1;
-
-        if (local_wg_size)
-        {
-            good_global_size = (global_wg_size[i] % local_wg_size[i] == 0);
-        }
-
-        if (good_global_size)
-        {
-            self->Global_Work_Size[i] = global_wg_size[i];
-        }
-        else
-        {
-            OCL_DIE_ON_ERROR(GLOBAL_NOT_MULTIPLE_TO_LOCAL, CL_SUCCESS, NULL,
-                    GLOBAL_NOT_MULTIPLE_TO_LOCAL);
-        }
+        return VALUE_OUT_OF_RANGE;
     }
 
+    Get_Chunk_Range(self, num_chunks, chunk_index, offset, size);
+
     return CL_SUCCESS;
 }
 
 /**
  * \related cl_Kernel
  *
- * This function enqueues kernel execution
+ * This function enqueues kernel execution as several launches, each of which
+ * processes its own chunk of ND range via global work offset. Arguments are
+ * bound by 'Bind_Arg' function pointer or by previous launches.
+ *
+ * Every chunk produces its own event, so commands in other queues (e. g.
+ * transfers of partial results) may wait for particular chunk, while further
+ * chunks are still computed.
  *
  * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
- * function pointer 'ND_Range' is defined to point on this function
+ * function pointer 'Launch_Chunked' is defined to point on this function
  * @param[in] queue OpenCL command queue, that will be used for kernel execution
+ * @param[in] num_chunks number of chunks, ND range is split into.
  * @param[in] evt_wait_list_size Size of list of OpenCL events, that must be
- * finished before kernel execution. If kernel doesn't need to wait for any
- * events, pass 0 as argument.
+ * finished before execution of each chunk. If kernel doesn't need to wait for
+ * any events, pass 0 as argument.
  * @param[in] evt_wait_list Pointer to array of OpenCL events. If kernel doesn't
  * need to wait for any events, pass NULL as argument.
- * @param[out] generated_evt Pointer to OpenCL event, that kernel will produce.
- * If kernel doesn't need to produce any event, pass NULL as argument
+ * @param[out] chunk_evts Pointer to array of 'num_chunks' OpenCL events, that
+ * chunks will produce. If they aren't needed, pass NULL as argument.
  * @param[in] time_measure_flag flag, that denotes if kernel execution time
- * should be gathered.
+ * should be gathered. Each chunk is measured as separate call.
 
  * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
  *
+ * @warning kernel must not rely on global id starting from zero in the slowest
+ * dimension.
+ *
  * @see cl_err_codes.h for details
  * @see description of structure 'cl_Error_t' for details about error handling
  */
-static ret_code Kernel_ND_Range(scow_Kernel* self, cl_command_queue* queue,
+static ret_code Kernel_Launch_Chunked(scow_Kernel* self,
+        cl_command_queue* queue, const cl_uint num_chunks,
         cl_uint evt_wait_list_size, const cl_event* evt_wait_list,
-        cl_event* generated_evt, TIME_STUDY_MODE time_measure_mode)
+        cl_event* chunk_evts, TIME_STUDY_MODE time_measure_mode)
 {
     cl_int ret;
-    cl_double run_time;
-    cl_event* p_evt;
+    size_t offset[MAX_NUM_DIMENSIONS] = { 0, 0, 0 },
+            global_size[MAX_NUM_DIMENSIONS];
 
-    if (generated_evt == NULL)
-    {
-        // Passing internal event to NDRange()
-        self->evt_check_priority = INTERNAL_EVT_PRIORITY;
-        p_evt = &self->internal_event;
-    }
-    else
-    {
-        // Passing external event to NDRange()
-        self->evt_check_priority = EXTERNAL_EVT_PRIORITY;
-        self->p_external_event = generated_evt;
-        p_evt = generated_evt;
-    }
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
 
-    // Check if we have Local Work Group size organization.
-    size_t* Local_Work_Size = NULL;
-    int have_local_work_groups = 0;
+    // Local size may be tuned here, so chunks are checked after
+    ret = Prepare_ND_Range(self, queue);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    for (int i = 0; i < self->Dimensionality; i++)
+    // The first chunk is checked, so that nothing is enqueued on error
+    ret = Kernel_Get_Chunk(self, num_chunks, 0, &offset[0], &global_size[0]);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    size_t last_dim = self->Dimensionality - 1;
+    memcpy(global_size, self->Global_Work_Size, sizeof(global_size));
+    offset[0] = 0;
+
+    for (cl_uint i = 0; i < num_chunks; i++)
     {
-        if (self->Local_Work_Size[i] != 0)
+        cl_event chunk_evt = NULL, *p_evt = NULL;
+
+        ret = Kernel_Get_Chunk(self, num_chunks, i, &offset[last_dim],
+                &global_size[last_dim]);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+        if (chunk_evts)
         {
-            have_local_work_groups++;
+            p_evt = &chunk_evts[i];
+        }
+        else if (i == num_chunks - 1)
+        {
+            // Status of kernel is status of its last chunk
+            p_evt = &self->internal_event;
+        }
+        else if (time_measure_mode != DONT_MEASURE)
+        {
+            p_evt = &chunk_evt;
         }
-    }
 
-    if (have_local_work_groups != 0)
-    {
-        Local_Work_Size = &self->Local_Work_Size[0];
-    }
+        ret = clEnqueueNDRangeKernel(*queue, self->kernel,
+                self->Dimensionality, offset, global_size,
+                Get_Local_Size(self), evt_wait_list_size, evt_wait_list,
+                p_evt);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    ret = clEnqueueNDRangeKernel(*queue, self->kernel, self->Dimensionality,
-            NULL, self->Global_Work_Size, Local_Work_Size, evt_wait_list_size,
-            evt_wait_list, p_evt);
+        ret = p_evt ?
+                self->timer->Measure_Event(self->timer, p_evt,
+                        time_measure_mode) : CL_SUCCESS;
 
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+        if (chunk_evt)
+        {
+            clReleaseEvent(chunk_evt);
+        }
 
-    if (time_measure_mode != DONT_MEASURE)
-    {
-        run_time = Gather_Time_uS(p_evt);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
     }
 
-    switch (time_measure_mode)
+    self->evt_check_priority = chunk_evts ?
+            EXTERNAL_EVT_PRIORITY : INTERNAL_EVT_PRIORITY;
+    if (chunk_evts)
     {
-    case MEASURE:
-        /* Increment num_calls only in this case to have average runtime, which
-         * is always consistent. */
-        self->timer->current_time_device = run_time;
-        self->timer->total_time_device += run_time;
-        self->timer->num_calls_device++;
-        break;
-
-    default:
-        break;
+        self->p_external_event = &chunk_evts[num_chunks - 1];
     }
 
-    return ret;
+    return CL_SUCCESS;
 }
 
 /**
  * \related cl_Kernel
  *
- * This function enqueues kernel execution without prior argument setting via
- * 'Set_Arg' function pointer.
+ * This function binds arguments from array & enqueues kernel execution. Only
+ * arguments, changed since previous enqueue, are passed to OpenCL kernel.
  *
  * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
- * function pointer 'Launck' is defined to point on this function
+ * function pointer 'Launch_Array' is defined to point on this function
  * @param[in] queue OpenCL command queue, that will be used for kernel execution
  * @param[in] evt_wait_list_size Size of list of OpenCL events, that must be
  * finished before kernel execution. If kernel doesn't need to wait for any
@@ -376,45 +1195,62 @@ static ret_code Kernel_ND_Range(scow_Kernel* self, cl_command_queue* queue,
  * If kernel doesn't need to produce any event, pass NULL as argument
  * @param[in] time_measure_flag flag, that denotes if kernel execution time
  * should be gathered.
- * @param[in] argument structure of type 'cl_Kernel_Arg_t', that describes
- * OpenCL kernel arguments characteristics, such as size and pointer to argument.
+ * @param[in] args array of 'num_args' structures of type 'cl_Kernel_Arg_t'.
 
  * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
  *
  * @see cl_err_codes.h for details
  * @see description of structure 'cl_Error_t' for details about error handling
  */
-static ret_code Kernel_Launch(scow_Kernel* self, cl_command_queue* queue,
+static ret_code Kernel_Launch_Array(scow_Kernel* self, cl_command_queue* queue,
         cl_uint evt_wait_list_size, const cl_event* evt_wait_list,
-        cl_event* generated_evt, TIME_STUDY_MODE time_measure_mode, ...)
+        cl_event* generated_evt, TIME_STUDY_MODE time_measure_mode,
+        const scow_Kernel_Arg* args)
 {
-    va_list kernel_arguments;
     cl_int ret;
 
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(args, INVALID_BUFFER_GIVEN);
 
-    // Other function arguments are kernel arguments. They are optional
-    va_start(kernel_arguments, time_measure_mode);
+    // Number of arguments is known only when kernel is ready
+    ret = Kernel_Wait_Ready(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    for (int i = 0; i < self->num_args; i++)
+    for (int i = 0; i < Get_User_Args_Num(self); i++)
     {
-        scow_Kernel_Arg curr_arg = va_arg(kernel_arguments, scow_Kernel_Arg);
-
-        ret = Kernel_Set_Arg(self, i, curr_arg.size, curr_arg.ptr);
-
-        if (ret != CL_SUCCESS)
-        {
-            va_end(kernel_arguments);
-            OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
-        }
+        ret = Kernel_Bind_Arg(self, i, args[i].size, args[i].ptr);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
     }
 
-    va_end(kernel_arguments);
-
     return Kernel_ND_Range(self, queue, evt_wait_list_size, evt_wait_list,
             generated_evt, time_measure_mode);
 }
 
+/**
+ * \related cl_Kernel
+ *
+ * This function passes arguments, bound since previous enqueue, to OpenCL
+ * kernel without enqueueing it. It's used by those, who enqueue OpenCL kernel
+ * on their own, such as command graphs.
+ *
+ * @param[in,out] self pointer to structure of type 'cl_Kernel', in which
+ * function pointer 'Flush_Args' is defined to point on this function
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ * @see description of structure 'cl_Error_t' for details about error handling
+ */
+static ret_code Kernel_Flush_Args(scow_Kernel* self)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    ret_code ret = Kernel_Wait_Ready(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    return Flush_Arg_Bindings(self);
+}
+
 /**
  * \related cl_Kernel
  *
@@ -434,7 +1270,7 @@ static char* Kernel_Get_Name(scow_Kernel* self)
 {
     OCL_CHECK_EXISTENCE(self, NULL);
 
-    if (self->kernel == ((cl_kernel) 0x0))
+    if (Kernel_Wait_Ready(self) != CL_SUCCESS)
     {
         self->error->Set_Last_Code(self->error, KERNEL_DOESNT_EXIST);
         return NULL;
@@ -475,21 +1311,39 @@ static ret_code Kernel_Check_Status(scow_Kernel* self)
             sizeof(cl_int), &self->exec_status, NULL);
 }
 
+/*! \cond PRIVATE */
+// Function pointers are the same for all kernels, so they are copied at once
+static const scow_Kernel kernel_prototype =
+{
+    .Destroy                = Kernel_Destroy,
+    .Set_ND_Sizes           = Kernel_Set_ND_Sizes,
+    .Set_ND_Sizes_Autotune  = Kernel_Set_ND_Sizes_Autotune,
+    .Set_ND_Sizes_Auto      = Kernel_Set_ND_Sizes_Auto,
+    .Set_ND_Sizes_Padded    = Kernel_Set_ND_Sizes_Padded,
+    .Get_Name               = Kernel_Get_Name,
+    .Launch                 = Kernel_Launch,
+    .Bind_Arg               = Kernel_Bind_Arg,
+    .Launch_Bound           = Kernel_Launch_Bound,
+    .Launch_Array           = Kernel_Launch_Array,
+    .Launch_Chunked         = Kernel_Launch_Chunked,
+    .Get_Chunk              = Kernel_Get_Chunk,
+    .Flush_Args             = Kernel_Flush_Args,
+    .Check_Status           = Kernel_Check_Status
+};
+/*! \endcond */
+
 /**
  * \related cl_Kernel
  *
  * This function allocates memory for structure, sets function pointers &
- * initializes OpenCL kernel.
+ * initializes OpenCL kernel from already built program.
  *
- * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
- * @param[in] how_to_get_sources enumeration, that describes in what way
- * kernel source or pre-built program is provided
- * @param[in] source this argument can either be filename, if kernel source is
- * provided in file, or pre-built program goes in file, or it's a string with
- * source code
+ * @param[in] parent_program program, which kernel is made from. Kernel holds
+ * reference to it until destroyed.
  * @param[in] kernel_name name of OpenCL kernel
- * @param[in] extra_params extra parameters, that will be used during programm
- * building stage, if pre-built program isn't provided.
+ * @param[in] given_kernel already created OpenCL kernel (e. g. by
+ * clCreateKernelsInProgram()), that will be owned by wrapper. This argument is
+ * optional - pass NULL to create kernel by name.
  *
  * @return pointer to allocated structure in case of success,
  * \ref VOID_KERNEL_PTR otherwise
@@ -497,130 +1351,150 @@ static ret_code Kernel_Check_Status(scow_Kernel* self)
  * @warning always use 'Destroy' function pointer to free memory, allocated by
  * this function.
  */
-scow_Kernel* Make_Kernel(scow_Steel_Thread* parent_steel_thread,
-        OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
-        const char* kernel_name, const char* extra_params)
+scow_Kernel* Make_Kernel_From_Program(scow_Program* parent_program,
+        const char* kernel_name, cl_kernel given_kernel)
 {
     scow_Kernel* self;
     cl_int ret;
-    char* src_file;
-
-    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_KERNEL_PTR);
-    OCL_CHECK_EXISTENCE(kernel_name, VOID_KERNEL_PTR);
 
-    if (strlen(kernel_name) > OCL_KERNEL_NAME_MAX_LEN)
+    if (!parent_program || !kernel_name
+            || strlen(kernel_name) >= OCL_KERNEL_NAME_MAX_LEN)
     {
+        if (given_kernel)
+        {
+            clReleaseKernel(given_kernel);
+        }
+
         return VOID_KERNEL_PTR;
     }
 
-    self = (scow_Kernel*) calloc(1, sizeof(*self));
+    scow_Slab* slab = parent_program->parent_steel_thread->kernel_slab;
+    self = (scow_Kernel*) slab->Alloc(slab);
 
-    OCL_CHECK_EXISTENCE(self, VOID_KERNEL_PTR);
-
-    self->Destroy = Kernel_Destroy;
-    self->Set_ND_Sizes = Kernel_Set_ND_Sizes;
-    self->Get_Name = Kernel_Get_Name;
-    self->Launch = Kernel_Launch;
-    self->Check_Status = Kernel_Check_Status;
-
-    self->parent_steel_thread = parent_steel_thread;
-    self->error = Make_Error();
-    self->timer = Make_Timer(self);
-
-    strcpy(self->name, kernel_name);
-
-    switch (how_to_get_sources)
+    if (!self)
     {
-    case READ_FROM_FILES:
-        // Argument 'file' acts as filename
-        src_file = Read_Source_File(source);
-
-        if (src_file == NULL)
+        if (given_kernel)
         {
-            self->Destroy(self);
-            error_message("Error while reading kernel source file.\n");
-            return VOID_KERNEL_PTR;
+            clReleaseKernel(given_kernel);
         }
 
-        break;
-
-    case READ_FROM_STRING:
-        // Argument 'file' acts as string with source code;
-        src_file = source;
-        break;
-
-    default:
-        self->Destroy(self);
         return VOID_KERNEL_PTR;
-        break;
     }
 
-    // Creating & building program
-    char* build_params = (char*) calloc(
-            strlen(self->parent_steel_thread->init_params)
-                    + strlen(extra_params) + 2, sizeof(*build_params));
+    *self = kernel_prototype;
 
-    strcat(build_params, self->parent_steel_thread->init_params);
-    strcat(build_params, extra_params);
+    self->parent_steel_thread = parent_program->parent_steel_thread;
+    self->error = Init_Error(&self->error_storage);
+    self->timer = Init_Timer(&self->timer_storage, self);
 
-    self->program = clCreateProgramWithSource(
-            self->parent_steel_thread->context, 1, (const char**) &src_file,
-            NULL, &ret);
+    strcpy(self->name, kernel_name);
 
-    ret |= clBuildProgram(self->program, 0, NULL, build_params, NULL, NULL);
+    self->parent_program = parent_program->Retain(parent_program);
+    __atomic_add_fetch(&parent_program->num_kernels, 1, __ATOMIC_RELAXED);
 
-    free(build_params);
+    if (given_kernel)
+    {
+        self->kernel = given_kernel;
+        self->program = parent_program->program;
 
-    if (ret != CL_SUCCESS)
+        ret = Query_Kernel_Info(self);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, self->Destroy(self), VOID_KERNEL_PTR);
+    }
+    else if (parent_program->Get_Build_Status(parent_program)
+            != CL_BUILD_IN_PROGRESS)
     {
-        size_t len = 0;
-        char *buffer;
+        ret = Kernel_Wait_Ready(self);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, self->Destroy(self), VOID_KERNEL_PTR);
+    }
 
-        clGetProgramBuildInfo(self->program,
-            self->parent_steel_thread->device->device_id,
-                CL_PROGRAM_BUILD_LOG, 0, NULL, &len);
+    // Otherwise kernel is created at first use, not to wait for build here
+    return self;
+}
 
-        buffer = calloc(len, sizeof(char));
+/**
+ * \related cl_Kernel
+ *
+ * This function allocates memory for structure, sets function pointers &
+ * initializes OpenCL kernel.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * kernel source or pre-built program is provided
+ * @param[in] source this argument can either be filename, if kernel source is
+ * provided in file (pre-built program is looked up in binary cache by that
+ * source), or it's a string with source code
+ * @param[in] kernel_name name of OpenCL kernel
+ * @param[in] extra_params extra parameters, that will be used during programm
+ * building stage, if pre-built program isn't provided.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_KERNEL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Kernel* Make_Kernel(scow_Steel_Thread* parent_steel_thread,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
+        const char* kernel_name, const char* extra_params)
+{
+    scow_Kernel* self;
+    scow_Program* program;
 
-        clGetProgramBuildInfo(self->program,
-            self->parent_steel_thread->device->device_id,
-                CL_PROGRAM_BUILD_LOG, len, buffer, NULL);
+    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_KERNEL_PTR);
+    OCL_CHECK_EXISTENCE(kernel_name, VOID_KERNEL_PTR);
 
-        error_message(buffer);
+    program = Make_Program(parent_steel_thread, how_to_get_sources, source,
+            extra_params);
+    OCL_CHECK_EXISTENCE(program, VOID_KERNEL_PTR);
 
-        free(buffer);
+    self = program->Get_Kernel(program, kernel_name);
 
-        if (how_to_get_sources == READ_FROM_FILES)
-        {
-            free(src_file);
-        }
+    // Kernel holds its own reference to program, so release ours
+    program->Destroy(program);
 
-        self->Destroy(self);
-        return VOID_KERNEL_PTR;
-    }
+    return self;
+}
 
-    // Creating the kernel
-    self->kernel = clCreateKernel(self->program, self->name, &ret);
+/**
+ * \related cl_Kernel
+ *
+ * This function allocates memory for structure, sets function pointers &
+ * initializes OpenCL kernel from program variant, specialized by compile-time
+ * constants. Identical variants are built once per Steel Thread.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * kernel source is provided
+ * @param[in] source this argument can either be filename, if kernel source is
+ * provided in file, or it's a string with source code
+ * @param[in] kernel_name name of OpenCL kernel
+ * @param[in] num_defines number of constants.
+ * @param[in] defines array of constants in form "NAME" or "NAME=VALUE".
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_KERNEL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Kernel* Make_Kernel_Variant(scow_Steel_Thread* parent_steel_thread,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char* source,
+        const char* kernel_name, cl_uint num_defines, const char** defines)
+{
+    scow_Kernel* self;
+    scow_Program* program;
 
-    if (ret != CL_SUCCESS)
-    {
-        ocl_error_message(ret);
+    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_KERNEL_PTR);
+    OCL_CHECK_EXISTENCE(kernel_name, VOID_KERNEL_PTR);
 
-        if (how_to_get_sources == READ_FROM_FILES)
-        {
-            free(src_file);
-        }
+    program = Make_Program_Variant(parent_steel_thread, how_to_get_sources,
+            source, num_defines, defines);
+    OCL_CHECK_EXISTENCE(program, VOID_KERNEL_PTR);
 
-        self->Destroy(self);
-        return VOID_KERNEL_PTR;
-    }
+    self = program->Get_Kernel(program, kernel_name);
 
-    if (how_to_get_sources == READ_FROM_FILES)
-    {
-        free(src_file);
-    }
+    // Kernel holds its own reference to program, so release ours
+    program->Destroy(program);
 
-    self->num_args = Get_Args_Num(self);
     return self;
 }
-
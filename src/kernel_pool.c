@@ -0,0 +1,284 @@
+/*
+ * @file kernel_pool.c
+ * @brief Provides pool of kernel instances for multi-threaded launching
+ *
+ * @see kernel_pool.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "kernel_pool.h"
+#include "steel_thread.h"
+#include "device.h"
+
+/*! \cond PRIVATE */
+#ifdef CL_VERSION_2_1
+static cl_bool Device_Supports_Clone(scow_Kernel_Pool *self)
+{
+    unsigned int major = 0, minor = 0;
+
+    sscanf(self->prototype->parent_steel_thread->device->device_version,
+            "OpenCL %u.%u", &major, &minor);
+
+    return (major > 2 || (major == 2 && minor >= 1)) ? CL_TRUE : CL_FALSE;
+}
+#endif
+
+// Called by owner of slot only, so no synchronization is needed
+static scow_Kernel* Make_Instance(scow_Kernel_Pool *self)
+{
+    scow_Kernel *prototype = self->prototype, *instance = VOID_KERNEL_PTR;
+    cl_kernel kernel = NULL;
+
+#ifdef CL_VERSION_2_1
+    if (prototype->kernel && Device_Supports_Clone(self))
+    {
+        cl_int ret = CL_SUCCESS;
+
+        // Clone inherits resources of prototype kernel
+        kernel = clCloneKernel(prototype->kernel, &ret);
+
+        if (ret != CL_SUCCESS)
+        {
+            kernel = NULL;
+        }
+    }
+#endif
+
+    instance = Make_Kernel_From_Program(prototype->parent_program,
+            prototype->name, kernel);
+    OCL_CHECK_EXISTENCE(instance, VOID_KERNEL_PTR);
+
+    instance->Dimensionality = prototype->Dimensionality;
+    for (cl_uint i = 0; i < MAX_NUM_DIMENSIONS; i++)
+    {
+        instance->Global_Work_Size[i] = prototype->Global_Work_Size[i];
+        instance->Local_Work_Size[i] = prototype->Local_Work_Size[i];
+        instance->Real_Work_Size[i] = prototype->Real_Work_Size[i];
+    }
+
+    /* Arguments are copied on both paths, so that instance doesn't depend on
+     * whether Device can clone kernels. They are passed at first launch. */
+    for (cl_uint i = 0; i < prototype->num_arg_bindings; i++)
+    {
+        Kernel_Arg_Binding *binding = &prototype->arg_bindings[i];
+
+        if (!binding->is_bound)
+        {
+            continue;
+        }
+
+        ret_code ret = instance->Bind_Arg(instance, i, binding->size,
+                binding->value);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, instance->Destroy(instance),
+                VOID_KERNEL_PTR);
+    }
+
+    // Real size argument is bound to instance like to prototype
+    if (prototype->pad_global_size)
+    {
+        unsigned int real_size[MAX_NUM_DIMENSIONS],
+                local_size[MAX_NUM_DIMENSIONS];
+
+        for (cl_uint i = 0; i < MAX_NUM_DIMENSIONS; i++)
+        {
+            real_size[i] = (unsigned int) prototype->Real_Work_Size[i];
+            local_size[i] = (unsigned int) prototype->Local_Work_Size[i];
+        }
+
+        ret_code ret = instance->Set_ND_Sizes_Padded(instance,
+                (unsigned int) prototype->Dimensionality, real_size,
+                local_size[0] ? local_size : NULL);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, instance->Destroy(instance),
+                VOID_KERNEL_PTR);
+    }
+
+    return instance;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Kernel_Pool
+ *
+ * This function acquires free instance of kernel. Instance is created, if
+ * slot is acquired for the first time.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Kernel_Pool', in which
+ * function pointer 'Acquire' is defined to point on this function.
+ *
+ * @return pointer to kernel instance in case of success, \ref VOID_KERNEL_PTR
+ * otherwise. If all instances are in use, last error code of pool is set to
+ * \ref KERNEL_IN_USE.
+ */
+static scow_Kernel* Kernel_Pool_Acquire(scow_Kernel_Pool *self)
+{
+    OCL_CHECK_EXISTENCE(self, VOID_KERNEL_PTR);
+
+    // Threads start search from different slots not to fight for the same ones
+    cl_uint start = __atomic_fetch_add(&self->next_slot, 1, __ATOMIC_RELAXED);
+
+    for (cl_uint i = 0; i < self->max_instances; i++)
+    {
+        cl_uint slot = (start + i) % self->max_instances, expected = 0;
+
+        if (!__atomic_compare_exchange_n(&self->in_use[slot], &expected, 1,
+                0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            continue;
+        }
+
+        if (!self->instances[slot])
+        {
+            self->instances[slot] = Make_Instance(self);
+        }
+
+        if (!self->instances[slot])
+        {
+            __atomic_store_n(&self->in_use[slot], 0, __ATOMIC_RELEASE);
+            self->error->Set_Last_Code(self->error, KERNEL_DOESNT_EXIST);
+            return VOID_KERNEL_PTR;
+        }
+
+        return self->instances[slot];
+    }
+
+    self->error->Set_Last_Code(self->error, KERNEL_IN_USE);
+    return VOID_KERNEL_PTR;
+}
+
+/**
+ * \related scow_Kernel_Pool
+ *
+ * This function returns kernel instance to pool. Commands, enqueued with
+ * instance, don't have to be finished.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Kernel_Pool', in which
+ * function pointer 'Release' is defined to point on this function.
+ * @param[in] instance kernel instance, acquired from this pool.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Kernel_Pool_Release(scow_Kernel_Pool *self,
+        scow_Kernel *instance)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(instance, INVALID_BUFFER_GIVEN);
+
+    for (cl_uint i = 0; i < self->max_instances; i++)
+    {
+        if (self->instances[i] == instance)
+        {
+            __atomic_store_n(&self->in_use[i], 0, __ATOMIC_RELEASE);
+            return CL_SUCCESS;
+        }
+    }
+
+    return INVALID_ARG_TYPE;
+}
+
+/**
+ * \related scow_Kernel_Pool
+ *
+ * This function destroys all kernel instances & frees memory, allocated for
+ * pool. Prototype kernel is left untouched.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Kernel_Pool', in which
+ * function pointer 'Destroy' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Kernel_Pool_Destroy(scow_Kernel_Pool *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    if (self->instances)
+    {
+        for (cl_uint i = 0; i < self->max_instances; i++)
+        {
+            if (self->instances[i])
+            {
+                self->instances[i]->Destroy(self->instances[i]);
+            }
+        }
+    }
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    free(self->in_use);
+    free(self->instances);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Kernel_Pool
+ *
+ * This function allocates memory for structure & sets function pointers.
+ *
+ * @param[in] prototype kernel, which instances are made from. Its ND sizes &
+ * arguments, bound by the moment of instance creation, are copied to each
+ * instance. It must outlive pool.
+ * @param[in] max_instances maximal number of instances, which may be acquired
+ * simultaneously. Usually it's number of Host threads.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_KERNEL_POOL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. All instances must be released before.
+ */
+scow_Kernel_Pool* Make_Kernel_Pool(scow_Kernel *prototype,
+        cl_uint max_instances)
+{
+    OCL_CHECK_EXISTENCE(prototype, VOID_KERNEL_POOL_PTR);
+
+    if (max_instances == 0)
+    {
+        return VOID_KERNEL_POOL_PTR;
+    }
+
+    scow_Kernel_Pool *self = (scow_Kernel_Pool*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_KERNEL_POOL_PTR);
+
+    self->Acquire = Kernel_Pool_Acquire;
+    self->Release = Kernel_Pool_Release;
+    self->Destroy = Kernel_Pool_Destroy;
+
+    self->prototype = prototype;
+    self->max_instances = max_instances;
+    self->error = Make_Error();
+
+    self->instances = (scow_Kernel**) calloc(max_instances,
+            sizeof(*self->instances));
+    self->in_use = (cl_uint*) calloc(max_instances, sizeof(*self->in_use));
+
+    if (!self->error || !self->instances || !self->in_use)
+    {
+        self->Destroy(self);
+        return VOID_KERNEL_POOL_PTR;
+    }
+
+    // Done once here, instances are cloned concurrently later
+    prototype->Flush_Args(prototype);
+
+    return self;
+}
@@ -15,37 +15,17 @@
  * See the License for the specific language governing permissions and
  * limitations under the License. */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include "mem_object.h"
 
 #include "steel_thread.h"
+#include "buffer_pool.h"
+#include "device.h"
+#include "slab.h"
 #include <stdlib.h>
 #include <string.h>
 
-/*! \cond PRIVATE
- * Gather event execution time in microseconds
- */
-static cl_double Gather_Time_uS(cl_event* event)
-{
-    cl_double no_time;
-    cl_ulong start, end;
-
-    no_time = -1.0;
-
-    OCL_CHECK_EXISTENCE(event, no_time);
-
-    clWaitForEvents(1, event);
-
-    start = end = 0;
-
-    clGetEventProfilingInfo(*event, CL_PROFILING_COMMAND_START,
-            sizeof(cl_ulong), &start, NULL);
-
-    clGetEventProfilingInfo(*event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong),
-            &end, NULL);
-
-    return (cl_double) (end - start) * (cl_double) (1e-03);
-}
-/*! \endcond */
 
 /**
  * \related cl_Mem_Object_t
@@ -83,13 +63,26 @@ static ret_code Mem_Object_Destroy(scow_Mem_Object *self)
      * CL_INVALID_MEM_OBJECT, as soon as we may go into 'Destroy()' function as
      * result of failed memory object creation attempt - that isn't error.
      */
-    ret = clReleaseMemObject(self->cl_mem_object);
+    if (self->is_pooled && self->parent_thread->buffer_pool)
+    {
+        ret = self->parent_thread->buffer_pool->Recycle(
+                self->parent_thread->buffer_pool, self->cl_mem_object,
+                self->mem_flags);
+    }
+    else
+    {
+        ret = clReleaseMemObject(self->cl_mem_object);
+    }
+
     if (ret != CL_SUCCESS && ret != CL_INVALID_MEM_OBJECT)
     {
         OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
     }
 
-    free(self);
+    free(self->dirty);
+
+    self->parent_thread->mem_object_slab->Free(
+            self->parent_thread->mem_object_slab, self);
     return CL_SUCCESS;
 }
 
@@ -250,15 +243,17 @@ static size_t Image_Get_Row_Pitch(scow_Mem_Object *self)
 /**
  * \related cl_Mem_Object_t
  *
- * This function maps OpenCL memory object into Host-accessible memory & returns
- * pointer to mapped memory
+ * This function maps range of OpenCL buffer into Host-accessible memory &
+ * returns pointer to mapped range.
  *
- * @param[in,out] self  pointer to structure, in which 'Map' function pointer
- * is defined to point on this function.
+ * @param[in,out] self  pointer to structure, in which 'Map_Range' function
+ * pointer is defined to point on this function.
  * @param[in] blocking_map flag of type 'cl_bool' that denotes, should operation
  * be blocking or not.
  * @param [in] map_flags mapping flags, that denotes how memory object should be
  * mapped
+ * @param[in] offset offset of range in bytes.
+ * @param[in] size size of range in bytes.
  * @param[in] time_mode enumeration, that denotes how time measurement should be
  * performed
  * @param[out] evt_to_generate pointer to OpenCL event that will be generated
@@ -271,12 +266,14 @@ static size_t Image_Get_Row_Pitch(scow_Mem_Object *self)
  * @see cl_err_codes.h for detailed error description.
  * @see 'cl_Error_t' structure for error handling.
  */
-static void* Buffer_Map(
-    scow_Mem_Object     *self, 
+static void* Buffer_Map_Range(
+    scow_Mem_Object     *self,
     cl_bool             blocking_map,
-    cl_map_flags        map_flags, 
+    cl_map_flags        map_flags,
+    size_t              offset,
+    size_t              size,
     TIME_STUDY_MODE     time_mode,
-    cl_event            *evt_to_generate, 
+    cl_event            *evt_to_generate,
     cl_command_queue    explicit_queue)
 {
     cl_int ret;
@@ -291,8 +288,14 @@ static void* Buffer_Map(
         return NULL;
     }
 
+    if (!size || offset + size > self->size)
+    {
+        self->error->Set_Last_Code(self->error, INVALID_BUFFER_SIZE);
+        return NULL;
+    }
+
     (evt_to_generate != NULL) ?
-            (p_mapping_ready = evt_to_generate) : 
+            (p_mapping_ready = evt_to_generate) :
             (p_mapping_ready = &mapping_ready);
 
     // We can't map the object, that is already mapped
@@ -310,25 +313,13 @@ static void* Buffer_Map(
      * destroyed without unmapping it at first.
      */
     self->mapped_to_region = clEnqueueMapBuffer(q, self->cl_mem_object,
-            blocking_map, map_flags, 0, self->size, 0,
+            blocking_map, map_flags, offset, size, 0,
             NULL, p_mapping_ready, &ret);
 
     OCL_DIE_ON_ERROR(ret, CL_SUCCESS,
             self->error->Set_Last_Code(self->error, ret), NULL);
 
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_mapping_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
-
-    case DONT_MEASURE:
-        break;
-
-    default:
-        break;
-    }
+    self->timer->Measure_Event(self->timer, p_mapping_ready, time_mode);
 
     if (p_mapping_ready != evt_to_generate){
         clReleaseEvent(*p_mapping_ready);
@@ -337,108 +328,205 @@ static void* Buffer_Map(
     return self->mapped_to_region;
 }
 
+/*! \cond PRIVATE */
+// Frees Host memory of zero-copy buffer, when runtime doesn't need it anymore
+static void CL_CALLBACK Free_Host_Memory(cl_mem memobj, void *user_data)
+{
+    (void) memobj;
+
+    free(user_data);
+}
+
+/* Transfers range of zero-copy buffer by mapping it. On shared memory mapping
+ * gives pointer into Host memory of buffer itself, so data is copied only if
+ * given pointer is elsewhere, and isn't touched at all otherwise. */
+static ret_code Zero_Copy_Transfer(
+    scow_Mem_Object     *self,
+    cl_command_queue    q,
+    cl_map_flags        map_flags,
+    size_t              offset,
+    size_t              size,
+    void                *host,
+    cl_event            *p_evt)
+{
+    cl_int ret;
+
+    void *mapped = clEnqueueMapBuffer(q, self->cl_mem_object, CL_TRUE,
+            map_flags, offset, size, 0, NULL, NULL, &ret);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    if (mapped != host && (map_flags & CL_MAP_WRITE))
+    {
+        memcpy(mapped, host, size);
+    }
+    else if (mapped != host)
+    {
+        memcpy(host, mapped, size);
+    }
+
+    return clEnqueueUnmapMemObject(q, self->cl_mem_object, mapped, 0, NULL,
+            p_evt);
+}
+/*! \endcond */
+
 /**
  * \related cl_Mem_Object_t
  *
- * This function map OpenCL Image into Host-accessible memory & returns pointer
- * to mapped memory region
- * @param[in,out] self  pointer to structure, in which 'Map' function pointer
- * is defined to point on this function.
- * @param[in] blocking_map flag of type 'cl_bool' that denotes, should operation
- * be blocking or not.
- * @param [in] map_flags mapping flags, that denotes how memory object should be
- * mapped
+ * This function writes data from Host-accessible memory into range of OpenCL
+ * buffer, so that only touched bytes are transferred.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Write_Range' function
+ * pointer is defined to point on this function.
+ * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
+ * @param[in] offset offset of range in buffer in bytes.
+ * @param[in] size size of range in bytes.
+ * @param[in] source pointer to Host-accessible memory region of 'size' bytes.
  * @param[in] time_mode enumeration, that denotes how time measurement should be
- * performed
+ * performed.
  * @param[out] evt_to_generate pointer to OpenCL event that will be generated
  * at the end of operation.
  *
- * @return pointer to Host-accessible region of memory in case of success, NULL
- * pointer otherwise. In that case function sets error value, which is available
- * through cl_Error_t structure, defined by pointer 'self->error'
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
  *
  * @see cl_err_codes.h for detailed error description.
  * @see 'cl_Error_t' structure for error handling.
  */
-static void* Image_Map(
-    scow_Mem_Object     *self, 
-    cl_bool             blocking_map,
-    cl_map_flags        map_flags, 
+static ret_code Buffer_Write_Range(
+    scow_Mem_Object     *self,
+    cl_bool             blocking_flag,
+    size_t              offset,
+    size_t              size,
+    const void          *source,
     TIME_STUDY_MODE     time_mode,
-    cl_event            *evt_to_generate, 
+    cl_event            *evt_to_generate,
     cl_command_queue    explicit_queue)
 {
-    cl_int ret;
+    cl_int ret = CL_SUCCESS;
+    cl_event write_ready, *p_write_ready = (cl_event*) 0x0;
 
-    cl_event mapping_ready, *p_mapping_ready;
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(source, INVALID_BUFFER_GIVEN);
+
+    if (!size || offset + size > self->size)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
 
-    const size_t origin[3] =
-    { 0, 0, 0 }, region[3] =
-    { self->width, self->height, 1 };
+    (evt_to_generate != NULL) ?
+            (p_write_ready = evt_to_generate) :
+            (p_write_ready = &write_ready);
 
-    OCL_CHECK_EXISTENCE(self, NULL);
+    cl_command_queue q = (explicit_queue == NULL) ?
+        (self->parent_thread->q_data_htod) :
+        (explicit_queue);
 
-    if (blocking_map > CL_TRUE)
+    if (self->is_zero_copy)
     {
-        self->error->Set_Last_Code(self->error, INVALID_BLOCKING_FLAG);
-        return NULL;
+        ret = Zero_Copy_Transfer(self, q, CL_MAP_WRITE, offset, size,
+                (void*) source, p_write_ready);
+    }
+    else
+    {
+        ret = clEnqueueWriteBuffer(q, self->cl_mem_object, blocking_flag,
+                offset, size, source, 0, NULL, p_write_ready);
     }
 
-    (evt_to_generate != NULL) ?
-            (p_mapping_ready = evt_to_generate) : (p_mapping_ready =
-                    &mapping_ready);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    // We can't map the object, that is already mapped
-    if (self->mapped_to_region != NULL)
+    self->timer->Measure_Event(self->timer, p_write_ready, time_mode);
+
+    if (p_write_ready != evt_to_generate){
+        clReleaseEvent(*p_write_ready);
+    }
+
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function reads range of OpenCL buffer into Host-accessible memory, so
+ * that only touched bytes are transferred.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Read_Range' function
+ * pointer is defined to point on this function.
+ * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
+ * @param[in] offset offset of range in buffer in bytes.
+ * @param[in] size size of range in bytes.
+ * @param[out] destination pointer to Host-accessible memory region of 'size'
+ * bytes.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Buffer_Read_Range(
+    scow_Mem_Object     *self,
+    cl_bool             blocking_flag,
+    size_t              offset,
+    size_t              size,
+    void                *destination,
+    TIME_STUDY_MODE     time_mode,
+    cl_event            *evt_to_generate,
+    cl_command_queue    explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+    cl_event read_ready, *p_read_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(destination, INVALID_BUFFER_GIVEN);
+
+    if (!size || offset + size > self->size)
     {
-        self->error->Set_Last_Code(self->error, BUFFER_IN_USE);
-        return VOID_MEM_OBJ_PTR;
+        return INVALID_BUFFER_SIZE;
     }
 
+    (evt_to_generate != NULL) ?
+            (p_read_ready = evt_to_generate) : (p_read_ready = &read_ready);
+
     cl_command_queue q =
             (explicit_queue == NULL) ?
                     (self->parent_thread->q_data_dtoh) : (explicit_queue);
 
-    /* Save mapped pointer inside a structure in case if memory object is being
-     * destroyed without unmapping it at first.
-     */
-    self->mapped_to_region = clEnqueueMapImage(q, self->cl_mem_object,
-            blocking_map, map_flags, origin, region, &self->row_pitch, NULL, 0,
-            NULL, p_mapping_ready, &ret);
-
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS,
-            self->error->Set_Last_Code(self->error, ret), NULL);
-
-    switch (time_mode)
+    if (self->is_zero_copy)
     {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_mapping_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
+        ret = Zero_Copy_Transfer(self, q, CL_MAP_READ, offset, size,
+                destination, p_read_ready);
+    }
+    else
+    {
+        ret = clEnqueueReadBuffer(q, self->cl_mem_object, blocking_flag,
+                offset, size, destination, 0, NULL, p_read_ready);
+    }
 
-    case DONT_MEASURE:
-        break;
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    default:
-        break;
-    }
+    self->timer->Measure_Event(self->timer, p_read_ready, time_mode);
 
-    if (p_mapping_ready != evt_to_generate){
-        clReleaseEvent(*p_mapping_ready);
+    if (p_read_ready != evt_to_generate){
+        clReleaseEvent(*p_read_ready);
     }
 
-    return self->mapped_to_region;
+    return ret;
 }
 
 /**
  * \related cl_Mem_Object_t
  *
- * This fucntion unmaps previously mapped memory for OpenCL buffer.
+ * This function copies range of one OpenCL buffer into another one.
  *
- * @param[in,out] self  pointer to structure, in which 'Unmap' function pointer
- * is defined to point on this function.
- * @param[out] p_mapped_ptr pointer to pointer, that was returned as the
- * result of mapping operation.
+ * @param[in,out] self  pointer to structure, in which 'Copy_Range' function
+ * pointer is defined to point on this function.
+ * @param[out] dest pointer to Memory Object, where data is copied to. It may
+ * be 'self', if ranges don't overlap.
+ * @param[in] src_offset offset of range in 'self' in bytes.
+ * @param[in] dst_offset offset of range in 'dest' in bytes.
+ * @param[in] size size of range in bytes.
  * @param[in] time_mode enumeration, that denotes how time measurement should be
  * performed.
  * @param[out] evt_to_generate pointer to OpenCL event that will be generated
@@ -449,94 +537,95 @@ static void* Image_Map(
  * @see cl_err_codes.h for detailed error description.
  * @see 'cl_Error_t' structure for error handling.
  */
-static ret_code Mem_Object_Unmap(
-    scow_Mem_Object         *self, 
-    cl_bool                 blocking_map,
-    void                    **p_mapped_ptr, 
+static ret_code Buffer_Copy_Range(
+    scow_Mem_Object         *self,
+    scow_Mem_Object         *dest,
+    size_t                  src_offset,
+    size_t                  dst_offset,
+    size_t                  size,
     TIME_STUDY_MODE         time_mode,
-    cl_event                *evt_to_generate, 
+    cl_event                *evt_to_generate,
     cl_command_queue        explicit_queue)
 {
-    cl_int ret;
-    cl_event *p_unmapping_ready;
+    cl_int ret = CL_SUCCESS;
+
+    cl_event copy_ready, *p_copy_ready = (cl_event*) 0x0;
 
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(self->mapped_to_region, MEM_OBJ_NOT_MAPPED);
+    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
 
-    if (p_mapped_ptr)
+    // Can't copy distinct memory objects
+    if (self->obj_mem_type != dest->obj_mem_type)
     {
-        OCL_CHECK_EXISTENCE(*p_mapped_ptr, INVALID_BUFFER_GIVEN);
+        return DISTINCT_MEM_OBJECTS;
+    }
 
-        /* Check if we are trying to unmap pointer, that was mapped from different
-         * Memory Object. */
-        if (self->mapped_to_region != *p_mapped_ptr)
-        {
-            OCL_DIE_ON_ERROR(WRONG_PARENT_OBJECT, CL_SUCCESS, NULL,
-                    WRONG_PARENT_OBJECT);
-        }
+    if (!size || src_offset + size > self->size ||
+            dst_offset + size > dest->size)
+    {
+        return INVALID_BUFFER_SIZE;
     }
 
-    /* We generate event in any case - because later we may want to wait for
-     * unmapping completion. */
-    (evt_to_generate != NULL) ?
-            (p_unmapping_ready = evt_to_generate) :
-            (p_unmapping_ready = &self->unmap_evt);
+    (evt_to_generate == NULL) ? (p_copy_ready = &copy_ready) : (p_copy_ready =
+                                        evt_to_generate);
 
     cl_command_queue q =
             (explicit_queue == NULL) ?
-                    (self->parent_thread->q_data_htod) : (explicit_queue);
+                    (self->parent_thread->q_data_dtod) : (explicit_queue);
 
-    ret = clEnqueueUnmapMemObject(q, self->cl_mem_object,
-            self->mapped_to_region, 0, NULL, p_unmapping_ready);
+    ret = clEnqueueCopyBuffer(q, self->cl_mem_object, dest->cl_mem_object,
+            src_offset, dst_offset, size, 0, NULL, p_copy_ready);
 
     OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    self->mapped_to_region = NULL;
-    self->row_pitch = 0;
+    self->timer->Measure_Event(self->timer, p_copy_ready, time_mode);
 
-    if (p_mapped_ptr != NULL)
-    {
-        *p_mapped_ptr = NULL;
+    if (p_copy_ready != evt_to_generate){
+        clReleaseEvent(*p_copy_ready);
     }
 
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_unmapping_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
+    return ret;
+}
 
-    case DONT_MEASURE:
-        break;
+/*! \cond PRIVATE */
+// Byte offset of the last byte of rectangle, which starts at origin, plus one
+static size_t Get_Rect_End(const size_t origin[3], const size_t region[3],
+        size_t row_pitch, size_t slice_pitch)
+{
+    row_pitch = row_pitch ? row_pitch : region[0];
+    slice_pitch = slice_pitch ? slice_pitch : row_pitch * region[1];
 
-    default:
-        if (blocking_map)
+    return (origin[2] + region[2] - 1) * slice_pitch +
+            (origin[1] + region[1] - 1) * row_pitch + origin[0] + region[0];
+}
+
+static cl_bool Is_Rect_Valid(const scow_Buffer_Rect *rect, size_t buffer_size)
+{
+    for (cl_uint i = 0; i < 3; i++)
+    {
+        if (!rect->region[i])
         {
-            ret = clWaitForEvents(1, p_unmapping_ready);
-            OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+            return CL_FALSE;
         }
-        break;
-    }
-
-    if (p_unmapping_ready != evt_to_generate){
-        clReleaseEvent(*p_unmapping_ready);
     }
 
-    return ret;
+    return Get_Rect_End(rect->buffer_origin, rect->region,
+            rect->buffer_row_pitch, rect->buffer_slice_pitch) <= buffer_size ?
+            CL_TRUE : CL_FALSE;
 }
+/*! \endcond */
 
 /**
  * \related cl_Mem_Object_t
  *
- * This function read data from Host-accessible memory region, defined by argument
- * 'source' & write that data into OpenCL buffer memory object, defined by
- * argument 'self'
+ * This function writes 2D or 3D rectangle from Host-accessible memory into
+ * OpenCL buffer, so that only rows of rectangle are transferred.
  *
- * @param[in,out] self  pointer to structure, in which 'Write' function pointer
- * is defined to point on this function.
+ * @param[in,out] self  pointer to structure, in which 'Write_Rect' function
+ * pointer is defined to point on this function.
  * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
- * @param[in] source pointer to Host-accessible memory region, that
- * contain data to be write in OpenCL memory object.
+ * @param[in] rect rectangle in buffer & in Host memory.
+ * @param[in] source pointer to Host-accessible memory.
  * @param[in] time_mode enumeration, that denotes how time measurement should be
  * performed.
  * @param[out] evt_to_generate pointer to OpenCL event that will be generated
@@ -547,47 +636,431 @@ static ret_code Mem_Object_Unmap(
  * @see cl_err_codes.h for detailed error description.
  * @see 'cl_Error_t' structure for error handling.
  */
-static ret_code Buffer_Send_To_Device(
+static ret_code Buffer_Write_Rect(
     scow_Mem_Object         *self,
-    cl_bool                 blocking_flag, 
-    void                    *source, 
+    cl_bool                 blocking_flag,
+    const scow_Buffer_Rect  *rect,
+    const void              *source,
     TIME_STUDY_MODE         time_mode,
-    cl_event                *evt_to_generate, 
+    cl_event                *evt_to_generate,
     cl_command_queue        explicit_queue)
 {
     cl_int ret = CL_SUCCESS;
     cl_event write_ready, *p_write_ready = (cl_event*) 0x0;
 
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(rect, INVALID_BUFFER_GIVEN);
     OCL_CHECK_EXISTENCE(source, INVALID_BUFFER_GIVEN);
 
+    if (!Is_Rect_Valid(rect, self->size))
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
     (evt_to_generate != NULL) ?
-            (p_write_ready = evt_to_generate) : 
+            (p_write_ready = evt_to_generate) :
             (p_write_ready = &write_ready);
 
-    cl_command_queue q = (explicit_queue == NULL) ? 
-        (self->parent_thread->q_data_htod) : 
+    cl_command_queue q = (explicit_queue == NULL) ?
+        (self->parent_thread->q_data_htod) :
         (explicit_queue);
 
-    ret = clEnqueueWriteBuffer(q, self->cl_mem_object, blocking_flag, 0,
-            self->size, source, 0, NULL, p_write_ready);
+    ret = clEnqueueWriteBufferRect(q, self->cl_mem_object, blocking_flag,
+            rect->buffer_origin, rect->host_origin, rect->region,
+            rect->buffer_row_pitch, rect->buffer_slice_pitch,
+            rect->host_row_pitch, rect->host_slice_pitch, source, 0, NULL,
+            p_write_ready);
 
     OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_write_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
+    self->timer->Measure_Event(self->timer, p_write_ready, time_mode);
 
-    case DONT_MEASURE:
-        break;
+    if (p_write_ready != evt_to_generate){
+        clReleaseEvent(*p_write_ready);
+    }
 
-    default:
-        break;
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function reads 2D or 3D rectangle of OpenCL buffer into
+ * Host-accessible memory, so that only rows of rectangle are transferred.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Read_Rect' function
+ * pointer is defined to point on this function.
+ * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
+ * @param[in] rect rectangle in buffer & in Host memory.
+ * @param[out] destination pointer to Host-accessible memory.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Buffer_Read_Rect(
+    scow_Mem_Object         *self,
+    cl_bool                 blocking_flag,
+    const scow_Buffer_Rect  *rect,
+    void                    *destination,
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate,
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+    cl_event read_ready, *p_read_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(rect, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(destination, INVALID_BUFFER_GIVEN);
+
+    if (!Is_Rect_Valid(rect, self->size))
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    (evt_to_generate != NULL) ?
+            (p_read_ready = evt_to_generate) : (p_read_ready = &read_ready);
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_dtoh) : (explicit_queue);
+
+    ret = clEnqueueReadBufferRect(q, self->cl_mem_object, blocking_flag,
+            rect->buffer_origin, rect->host_origin, rect->region,
+            rect->buffer_row_pitch, rect->buffer_slice_pitch,
+            rect->host_row_pitch, rect->host_slice_pitch, destination, 0, NULL,
+            p_read_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->timer->Measure_Event(self->timer, p_read_ready, time_mode);
+
+    if (p_read_ready != evt_to_generate){
+        clReleaseEvent(*p_read_ready);
+    }
+
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function copies 2D or 3D rectangle of one OpenCL buffer into another.
+ * Host fields of rectangle describe rectangle in 'dest'.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Copy_Rect' function
+ * pointer is defined to point on this function.
+ * @param[out] dest pointer to Memory Object, where data is copied to.
+ * @param[in] rect rectangle in 'self' (buffer fields) & in 'dest' (host
+ * fields).
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Buffer_Copy_Rect(
+    scow_Mem_Object         *self,
+    scow_Mem_Object         *dest,
+    const scow_Buffer_Rect  *rect,
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate,
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+    cl_event copy_ready, *p_copy_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(rect, INVALID_BUFFER_GIVEN);
+
+    if (self->obj_mem_type != dest->obj_mem_type)
+    {
+        return DISTINCT_MEM_OBJECTS;
+    }
+
+    if (!Is_Rect_Valid(rect, self->size) ||
+            Get_Rect_End(rect->host_origin, rect->region, rect->host_row_pitch,
+                    rect->host_slice_pitch) > dest->size)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    (evt_to_generate == NULL) ? (p_copy_ready = &copy_ready) : (p_copy_ready =
+                                        evt_to_generate);
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_dtod) : (explicit_queue);
+
+    ret = clEnqueueCopyBufferRect(q, self->cl_mem_object, dest->cl_mem_object,
+            rect->buffer_origin, rect->host_origin, rect->region,
+            rect->buffer_row_pitch, rect->buffer_slice_pitch,
+            rect->host_row_pitch, rect->host_slice_pitch, 0, NULL,
+            p_copy_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->timer->Measure_Event(self->timer, p_copy_ready, time_mode);
+
+    if (p_copy_ready != evt_to_generate){
+        clReleaseEvent(*p_copy_ready);
+    }
+
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function maps OpenCL memory object into Host-accessible memory & returns
+ * pointer to mapped memory
+ *
+ * @param[in,out] self  pointer to structure, in which 'Map' function pointer
+ * is defined to point on this function.
+ * @param[in] blocking_map flag of type 'cl_bool' that denotes, should operation
+ * be blocking or not.
+ * @param [in] map_flags mapping flags, that denotes how memory object should be
+ * mapped
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return pointer to Host-accessible region of memory in case of success, NULL
+ * pointer otherwise. In that case function sets error value, which is available
+ * through cl_Error_t structure, defined by pointer 'self->error'
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static void* Buffer_Map(
+    scow_Mem_Object     *self, 
+    cl_bool             blocking_map,
+    cl_map_flags        map_flags, 
+    TIME_STUDY_MODE     time_mode,
+    cl_event            *evt_to_generate, 
+    cl_command_queue    explicit_queue)
+{
+    OCL_CHECK_EXISTENCE(self, NULL);
+
+    return Buffer_Map_Range(self, blocking_map, map_flags, 0, self->size,
+            time_mode, evt_to_generate, explicit_queue);
+}
+
+
+/*! \cond PRIVATE */
+/* Region of whole Image as OpenCL sees it: layers of image array are indexed
+ * by the coordinate, which follows the last one of single image. */
+static void Get_Image_Region(const scow_Mem_Object *self, size_t region[3])
+{
+    region[0] = self->width;
+    region[1] = self->height;
+    region[2] = self->depth;
+
+    if (self->image_type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+    {
+        region[1] = self->array_size;
+    }
+    else if (self->image_type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+    {
+        region[2] = self->array_size;
+    }
+}
+
+// Region must be non-empty & lie within Image
+static cl_bool Is_Region_Valid(const scow_Mem_Object *self,
+        const size_t origin[3], const size_t region[3])
+{
+    size_t full[3];
+
+    Get_Image_Region(self, full);
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (!region[i] || origin[i] + region[i] > full[i])
+        {
+            return CL_FALSE;
+        }
+    }
+
+    return CL_TRUE;
+}
+
+// Whole Image with given Host row pitch
+static scow_Image_Region Get_Whole_Region(const scow_Mem_Object *self,
+        size_t row_pitch)
+{
+    scow_Image_Region region = {
+        .origin         = { 0, 0, 0 },
+        .dest_origin    = { 0, 0, 0 },
+        .row_pitch      = row_pitch,
+        .slice_pitch    = 0
+    };
+
+    Get_Image_Region(self, region.region);
+
+    return region;
+}
+/*! \endcond */
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function maps region of OpenCL Image into Host-accessible memory &
+ * returns pointer to mapped region. Row & slice pitches of mapping are stored
+ * in 'row_pitch' & 'slice_pitch' fields.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Map_Region' function
+ * pointer is defined to point on this function.
+ * @param[in] blocking_map flag of type 'cl_bool' that denotes, should operation
+ * be blocking or not.
+ * @param [in] map_flags mapping flags, that denotes how memory object should be
+ * mapped
+ * @param[in] region region to map. Host pitches are ignored.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return pointer to Host-accessible region of memory in case of success, NULL
+ * pointer otherwise. In that case function sets error value, which is available
+ * through cl_Error_t structure, defined by pointer 'self->error'
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static void* Image_Map_Region(
+    scow_Mem_Object         *self,
+    cl_bool                 blocking_map,
+    cl_map_flags            map_flags,
+    const scow_Image_Region *region,
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate,
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret;
+
+    cl_event mapping_ready, *p_mapping_ready;
+
+    OCL_CHECK_EXISTENCE(self, NULL);
+    OCL_CHECK_EXISTENCE(region, NULL);
+
+    if (blocking_map > CL_TRUE)
+    {
+        self->error->Set_Last_Code(self->error, INVALID_BLOCKING_FLAG);
+        return NULL;
+    }
+
+    if (!Is_Region_Valid(self, region->origin, region->region))
+    {
+        self->error->Set_Last_Code(self->error, INVALID_BUFFER_SIZE);
+        return NULL;
+    }
+
+    (evt_to_generate != NULL) ?
+            (p_mapping_ready = evt_to_generate) : (p_mapping_ready =
+                    &mapping_ready);
+
+    // We can't map the object, that is already mapped
+    if (self->mapped_to_region != NULL)
+    {
+        self->error->Set_Last_Code(self->error, BUFFER_IN_USE);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_dtoh) : (explicit_queue);
+
+    /* Save mapped pointer inside a structure in case if memory object is being
+     * destroyed without unmapping it at first.
+     */
+    self->mapped_to_region = clEnqueueMapImage(q, self->cl_mem_object,
+            blocking_map, map_flags, region->origin, region->region,
+            &self->row_pitch, &self->slice_pitch, 0, NULL, p_mapping_ready,
+            &ret);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS,
+            self->error->Set_Last_Code(self->error, ret), NULL);
+
+    self->timer->Measure_Event(self->timer, p_mapping_ready, time_mode);
+
+    if (p_mapping_ready != evt_to_generate){
+        clReleaseEvent(*p_mapping_ready);
+    }
+
+    return self->mapped_to_region;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function writes region of OpenCL Image from Host-accessible memory,
+ * laid out with given pitches.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Write_Region' function
+ * pointer is defined to point on this function.
+ * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
+ * @param[in] region region to write & pitches of Host memory.
+ * @param[in] source pointer to Host-accessible memory with region data.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Image_Write_Region(
+    scow_Mem_Object         *self,
+    cl_bool                 blocking_flag,
+    const scow_Image_Region *region,
+    const void              *source,
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate,
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+
+    cl_event write_ready, *p_write_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(region, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(source, INVALID_BUFFER_GIVEN);
+
+    if (!Is_Region_Valid(self, region->origin, region->region))
+    {
+        return INVALID_BUFFER_SIZE;
     }
 
+    (evt_to_generate != NULL) ?
+            (p_write_ready = evt_to_generate) : (p_write_ready = &write_ready);
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_htod) : (explicit_queue);
+
+    ret = clEnqueueWriteImage(q, self->cl_mem_object, blocking_flag,
+            region->origin, region->region, region->row_pitch,
+            region->slice_pitch, source, 0, NULL, p_write_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->timer->Measure_Event(self->timer, p_write_ready, time_mode);
+
     if (p_write_ready != evt_to_generate){
         clReleaseEvent(*p_write_ready);
     }
@@ -595,6 +1068,305 @@ static ret_code Buffer_Send_To_Device(
     return ret;
 }
 
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function reads region of OpenCL Image into Host-accessible memory,
+ * laid out with given pitches.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Read_Region' function
+ * pointer is defined to point on this function.
+ * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
+ * @param[in] region region to read & pitches of Host memory.
+ * @param[out] destination pointer to Host-accessible memory for region data.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Image_Read_Region(
+    scow_Mem_Object         *self,
+    cl_bool                 blocking_flag,
+    const scow_Image_Region *region,
+    void                    *destination,
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate,
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+
+    cl_event read_ready, *p_read_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(region, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(destination, INVALID_BUFFER_GIVEN);
+
+    if (!Is_Region_Valid(self, region->origin, region->region))
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    (evt_to_generate != NULL) ?
+            (p_read_ready = evt_to_generate) : (p_read_ready = &read_ready);
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_dtoh) : (explicit_queue);
+
+    ret = clEnqueueReadImage(q, self->cl_mem_object, blocking_flag,
+            region->origin, region->region, region->row_pitch,
+            region->slice_pitch, destination, 0, NULL, p_read_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->timer->Measure_Event(self->timer, p_read_ready, time_mode);
+
+    if (p_read_ready != evt_to_generate){
+        clReleaseEvent(*p_read_ready);
+    }
+
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function copies region of one OpenCL Image into another one. Images
+ * must have the same format.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Copy_Region' function
+ * pointer is defined to point on this function.
+ * @param[out] dest pointer to Memory Object, where data is copied to. It may
+ * be 'self', if regions don't overlap.
+ * @param[in] region region to copy & its origin in 'dest'. Host pitches are
+ * ignored.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Image_Copy_Region(
+    scow_Mem_Object         *self,
+    scow_Mem_Object         *dest,
+    const scow_Image_Region *region,
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate,
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+
+    cl_event copy_ready, *p_copy_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(region, INVALID_BUFFER_GIVEN);
+
+    if (self->obj_mem_type != dest->obj_mem_type)
+    {
+        return DISTINCT_MEM_OBJECTS;
+    }
+
+    if (!Is_Region_Valid(self, region->origin, region->region) ||
+            !Is_Region_Valid(dest, region->dest_origin, region->region))
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    (evt_to_generate != NULL) ?
+            (p_copy_ready = evt_to_generate) : (p_copy_ready = &copy_ready);
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_dtod) : (explicit_queue);
+
+    ret = clEnqueueCopyImage(q, self->cl_mem_object, dest->cl_mem_object,
+            region->origin, region->dest_origin, region->region, 0, NULL,
+            p_copy_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->timer->Measure_Event(self->timer, p_copy_ready, time_mode);
+
+    if (p_copy_ready != evt_to_generate){
+        clReleaseEvent(*p_copy_ready);
+    }
+
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function map OpenCL Image into Host-accessible memory & returns pointer
+ * to mapped memory region
+ * @param[in,out] self  pointer to structure, in which 'Map' function pointer
+ * is defined to point on this function.
+ * @param[in] blocking_map flag of type 'cl_bool' that denotes, should operation
+ * be blocking or not.
+ * @param [in] map_flags mapping flags, that denotes how memory object should be
+ * mapped
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return pointer to Host-accessible region of memory in case of success, NULL
+ * pointer otherwise. In that case function sets error value, which is available
+ * through cl_Error_t structure, defined by pointer 'self->error'
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static void* Image_Map(
+    scow_Mem_Object     *self, 
+    cl_bool             blocking_map,
+    cl_map_flags        map_flags, 
+    TIME_STUDY_MODE     time_mode,
+    cl_event            *evt_to_generate, 
+    cl_command_queue    explicit_queue)
+{
+    OCL_CHECK_EXISTENCE(self, NULL);
+
+    scow_Image_Region region = Get_Whole_Region(self, 0);
+
+    return Image_Map_Region(self, blocking_map, map_flags, &region, time_mode,
+            evt_to_generate, explicit_queue);
+}
+
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This fucntion unmaps previously mapped memory for OpenCL buffer.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Unmap' function pointer
+ * is defined to point on this function.
+ * @param[in] blocking_map flag of type 'cl_bool' that denotes, should function
+ * wait for unmapping completion.
+ * @param[out] p_mapped_ptr pointer to pointer, that was returned as the
+ * result of mapping operation.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Mem_Object_Unmap(
+    scow_Mem_Object         *self, 
+    cl_bool                 blocking_map,
+    void                    **p_mapped_ptr, 
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate, 
+    cl_command_queue        explicit_queue)
+{
+    cl_int ret;
+    cl_event *p_unmapping_ready;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(self->mapped_to_region, MEM_OBJ_NOT_MAPPED);
+
+    if (p_mapped_ptr)
+    {
+        OCL_CHECK_EXISTENCE(*p_mapped_ptr, INVALID_BUFFER_GIVEN);
+
+        /* Check if we are trying to unmap pointer, that was mapped from different
+         * Memory Object. */
+        if (self->mapped_to_region != *p_mapped_ptr)
+        {
+            OCL_DIE_ON_ERROR(WRONG_PARENT_OBJECT, CL_SUCCESS, NULL,
+                    WRONG_PARENT_OBJECT);
+        }
+    }
+
+    /* We generate event in any case - because later we may want to wait for
+     * unmapping completion. */
+    (evt_to_generate != NULL) ?
+            (p_unmapping_ready = evt_to_generate) :
+            (p_unmapping_ready = &self->unmap_evt);
+
+    cl_command_queue q =
+            (explicit_queue == NULL) ?
+                    (self->parent_thread->q_data_htod) : (explicit_queue);
+
+    ret = clEnqueueUnmapMemObject(q, self->cl_mem_object,
+            self->mapped_to_region, 0, NULL, p_unmapping_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->mapped_to_region = NULL;
+    self->row_pitch = 0;
+
+    if (p_mapped_ptr != NULL)
+    {
+        *p_mapped_ptr = NULL;
+    }
+
+    // Unmap command has no blocking flag, so blocking is done by waiting
+    if (blocking_map && time_mode != MEASURE)
+    {
+        ret = clWaitForEvents(1, p_unmapping_ready);
+    }
+
+    self->timer->Measure_Event(self->timer, p_unmapping_ready, time_mode);
+
+    if (p_unmapping_ready != evt_to_generate){
+        clReleaseEvent(*p_unmapping_ready);
+    }
+
+    return ret;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function read data from Host-accessible memory region, defined by argument
+ * 'source' & write that data into OpenCL buffer memory object, defined by
+ * argument 'self'
+ *
+ * @param[in,out] self  pointer to structure, in which 'Write' function pointer
+ * is defined to point on this function.
+ * @param[in] blocking_flag flag, that denotes, should operation be blocking or not.
+ * @param[in] source pointer to Host-accessible memory region, that
+ * contain data to be write in OpenCL memory object.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Buffer_Send_To_Device(
+    scow_Mem_Object         *self,
+    cl_bool                 blocking_flag, 
+    void                    *source, 
+    TIME_STUDY_MODE         time_mode,
+    cl_event                *evt_to_generate, 
+    cl_command_queue        explicit_queue)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    return Buffer_Write_Range(self, blocking_flag, 0, self->size, source,
+            time_mode, evt_to_generate, explicit_queue);
+}
+
+
 /**
  * \related cl_Mem_Object_t
  *
@@ -624,50 +1396,15 @@ static ret_code Image_Send_To_Device(
     cl_event            *evt_to_generate, 
     cl_command_queue    explicit_queue)
 {
-    cl_int ret = CL_SUCCESS;
-
-    cl_event write_ready, *p_write_ready = (cl_event*) 0x0;
-
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(source, INVALID_BUFFER_GIVEN);
-
-    const size_t origin[3] =
-    { 0, 0, 0 }, region[3] =
-    { self->width, self->height, 1 };
-
-    (evt_to_generate != NULL) ?
-            (p_write_ready = evt_to_generate) : (p_write_ready = &write_ready);
-
-    cl_command_queue q =
-            (explicit_queue == NULL) ?
-                    (self->parent_thread->q_data_htod) : (explicit_queue);
-
-    ret = clEnqueueWriteImage(q, self->cl_mem_object, blocking_flag, origin,
-            region, self->row_pitch, 0, source, 0, NULL, p_write_ready);
-
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
-
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_write_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
-
-    case DONT_MEASURE:
-        break;
-
-    default:
-        break;
-    }
 
-    if (p_write_ready != evt_to_generate){
-        clReleaseEvent(*p_write_ready);
-    }
+    scow_Image_Region region = Get_Whole_Region(self, self->row_pitch);
 
-    return ret;
+    return Image_Write_Region(self, blocking_flag, &region, source, time_mode,
+            evt_to_generate, explicit_queue);
 }
 
+
 /**
  * \related cl_Mem_Object_t
  *
@@ -697,46 +1434,13 @@ static ret_code Buffer_Get_From_Device(
     cl_event            *evt_to_generate, 
     cl_command_queue    explicit_queue)
 {
-    cl_int ret = CL_SUCCESS;
-
-    cl_event read_ready, *p_read_ready = (cl_event*) 0x0;
-
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(destination, INVALID_BUFFER_GIVEN);
-
-    (evt_to_generate != NULL) ?
-            (p_read_ready = evt_to_generate) : (p_read_ready = &read_ready);
-
-    cl_command_queue q =
-            (explicit_queue == NULL) ?
-                    (self->parent_thread->q_data_dtoh) : (explicit_queue);
-
-    ret = clEnqueueReadBuffer(q, self->cl_mem_object, blocking_flag, 0,
-            self->size, destination, 0, NULL, p_read_ready);
-
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
-
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_read_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
-
-    case DONT_MEASURE:
-        break;
-
-    default:
-        break;
-    }
-
-    if (p_read_ready != evt_to_generate){
-        clReleaseEvent(*p_read_ready);
-    }
 
-    return ret;
+    return Buffer_Read_Range(self, blocking_flag, 0, self->size, destination,
+            time_mode, evt_to_generate, explicit_queue);
 }
 
+
 /**
  * \related cl_Mem_Object_t
  *
@@ -766,50 +1470,15 @@ static ret_code Image_Get_From_Device(
     cl_event                *evt_to_generate, 
     cl_command_queue        explicit_queue)
 {
-    cl_int ret = CL_SUCCESS;
-
-    cl_event read_ready, *p_read_ready = (cl_event*) 0x0;
-
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(destination, INVALID_BUFFER_GIVEN);
-
-    const size_t origin[3] =
-    { 0, 0, 0 }, region[3] =
-    { self->width, self->height, 1 };
-
-    (evt_to_generate != NULL) ?
-            (p_read_ready = evt_to_generate) : (p_read_ready = &read_ready);
-
-    cl_command_queue q =
-            (explicit_queue == NULL) ?
-                    (self->parent_thread->q_data_dtoh) : (explicit_queue);
 
-    ret = clEnqueueReadImage(q, self->cl_mem_object, blocking_flag, origin,
-            region, self->row_pitch, 0, destination, 0, NULL, p_read_ready);
-
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
-
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_read_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
-
-    case DONT_MEASURE:
-        break;
-
-    default:
-        break;
-    }
-
-    if (p_read_ready != evt_to_generate){
-        clReleaseEvent(*p_read_ready);
-    }
+    scow_Image_Region region = Get_Whole_Region(self, self->row_pitch);
 
-    return ret;
+    return Image_Read_Region(self, blocking_flag, &region, destination,
+            time_mode, evt_to_generate, explicit_queue);
 }
 
+
 /**
  * \related cl_Mem_Object_t
  *
@@ -838,10 +1507,6 @@ static ret_code Buffer_Copy(
     cl_event                *evt_to_generate, 
     cl_command_queue        explicit_queue)
 {
-    cl_int ret = CL_SUCCESS;
-
-    cl_event copy_ready, *p_copy_ready = (cl_event*) 0x0;
-
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
     OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
 
@@ -864,36 +1529,11 @@ static ret_code Buffer_Copy(
         return CL_SUCCESS;
     }
 
-    (evt_to_generate == NULL) ? (p_copy_ready = &copy_ready) : (p_copy_ready =
-                                        evt_to_generate);
-
-    cl_command_queue q =
-            (explicit_queue == NULL) ?
-                    (self->parent_thread->q_data_dtod) : (explicit_queue);
-
-    ret = clEnqueueCopyBuffer(q, self->cl_mem_object, dest->cl_mem_object, 0, 0,
-            self->size, 0, NULL, p_copy_ready);
-
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
-
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_copy_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
-
-    default:
-        break;
-    }
-
-    if (p_copy_ready != evt_to_generate){
-        clReleaseEvent(*p_copy_ready);
-    }
-
-    return ret;
+    return Buffer_Copy_Range(self, dest, 0, 0, self->size, time_mode,
+            evt_to_generate, explicit_queue);
 }
 
+
 /**
  * \related cl_Mem_Object_t
  *
@@ -921,13 +1561,8 @@ static ret_code Image_Copy(
     cl_event                *evt_to_generate, 
     cl_command_queue        explicit_queue)
 {
-    cl_int ret = CL_SUCCESS;
-
-    cl_event copy_ready, *p_copy_ready = (cl_event*) 0x0;
-
-    const size_t origin[3] =
-    { 0, 0, 0 }, region[3] =
-    { self->width, self->height, 1 };
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
 
     if (self->obj_mem_type != dest->obj_mem_type)
     {
@@ -943,44 +1578,140 @@ static ret_code Image_Copy(
         return CL_SUCCESS;
     }
 
-    (evt_to_generate != NULL) ?
-            (p_copy_ready = evt_to_generate) : (p_copy_ready = &copy_ready);
+    // Can't copy bigger image into smaller one
+    if ((self->row_pitch > dest->row_pitch) || (self->height > dest->height)
+            || (self->width > dest->width) || (self->depth > dest->depth)
+            || (self->array_size > dest->array_size))
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    scow_Image_Region region = Get_Whole_Region(self, 0);
+
+    return Image_Copy_Region(self, dest, &region, time_mode, evt_to_generate,
+            explicit_queue);
+}
+
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function swaps pointers to OpenCL memory objects. It can be used in
+ * some cases as quicker alternative to copy.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Swap' function pointer
+ * is defined to point on this function.
+ * @param[in,out] dest pointer to structure with which memory objects will be
+ * swapped
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Mem_Object_Swap(scow_Mem_Object **self, scow_Mem_Object **dest)
+{
+    scow_Mem_Object* temp;
 
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
     OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
 
-    // Can't copy bigger image into smaller one
-    if ((self->row_pitch > dest->row_pitch) || (self->height > dest->height)
-            || (self->width > dest->width))
+    OCL_CHECK_EXISTENCE(*self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(*dest, INVALID_BUFFER_GIVEN);
+
+    // Order of conditions is important
+    if ((*self)->obj_mem_type != (*dest)->obj_mem_type)
+    {
+        return DISTINCT_MEM_OBJECTS;
+    }
+
+    if ((*self)->mem_flags != (*dest)->mem_flags)
+    {
+        return DISTINCT_MEM_FLAGS;
+    }
+
+    if ((*self)->size != (*dest)->size)
     {
         return INVALID_BUFFER_SIZE;
     }
 
-    cl_command_queue q =
-            (explicit_queue == NULL) ?
-                    (self->parent_thread->q_data_dtod) : (explicit_queue);
+    // No OpenCL Device-side operations are made
+    temp = *self;
+    *self = *dest;
+    *dest = temp;
 
-    ret = clEnqueueCopyImage(q, self->cl_mem_object, dest->cl_mem_object,
-            origin, origin, region, 0, NULL, p_copy_ready);
+    return CL_SUCCESS;
+}
 
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function fills range of Buffer with repeated pattern on Device side,
+ * so that no data is transferred over the bus.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Fill' function pointer
+ * is defined to point on this function.
+ * @param[in] pattern pointer to pattern. It's copied at enqueue.
+ * @param[in] pattern_size size of pattern in bytes: 1, 2, 4, ..., 128.
+ * @param[in] offset offset of range in bytes. Must be multiple of pattern size.
+ * @param[in] size size of range in bytes. Must be multiple of pattern size.
+ * Zero fills Buffer from offset till end.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ * @param[in] explicit_queue command queue. If NULL, queue for Device to Device
+ * transmission of parent Steel Thread is used.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ * @see 'cl_Error_t' structure for error handling.
+ */
+static ret_code Buffer_Fill(
+    scow_Mem_Object     *self,
+    const void          *pattern,
+    size_t              pattern_size,
+    size_t              offset,
+    size_t              size,
+    TIME_STUDY_MODE     time_mode,
+    cl_event            *evt_to_generate,
+    cl_command_queue    explicit_queue)
+{
+    cl_int ret = CL_SUCCESS;
+    cl_event fill_ready, *p_fill_ready = (cl_event*) 0x0;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(pattern, INVALID_BUFFER_GIVEN);
+
+    if (!size && offset < self->size)
+    {
+        size = self->size - offset;
+    }
+
+    if (!pattern_size || offset % pattern_size || size % pattern_size ||
+            !size || offset + size > self->size)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    (evt_to_generate != NULL) ?
+            (p_fill_ready = evt_to_generate) :
+            (p_fill_ready = &fill_ready);
+
+    cl_command_queue q = (explicit_queue == NULL) ?
+        (self->parent_thread->q_data_dtod) :
+        (explicit_queue);
 
-    switch (time_mode)
-    {
-    case MEASURE:
-        self->timer->current_time_device = Gather_Time_uS(p_copy_ready);
-        self->timer->total_time_device += self->timer->current_time_device;
-        break;
+    ret = clEnqueueFillBuffer(q, self->cl_mem_object, pattern, pattern_size,
+            offset, size, 0, NULL, p_fill_ready);
 
-    case DONT_MEASURE:
-        break;
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
-    default:
-        break;
-    }
+    self->timer->Measure_Event(self->timer, p_fill_ready, time_mode);
 
-    if (p_copy_ready != evt_to_generate){
-        clReleaseEvent(*p_copy_ready);
+    if (p_fill_ready != evt_to_generate){
+        clReleaseEvent(*p_fill_ready);
     }
 
     return ret;
@@ -989,57 +1720,91 @@ static ret_code Image_Copy(
 /**
  * \related cl_Mem_Object_t
  *
- * This function swaps pointers to OpenCL memory objects. It can be used in
- * some cases as quicker alternative to copy.
+ * This function fills range of Image rows with single color on Device side.
+ * For 3D images & 2D image arrays rows are filled in every slice, for 1D
+ * image arrays rows are images of array.
  *
- * @param[in,out] self  pointer to structure, in which 'Swap' function pointer
+ * @param[in,out] self  pointer to structure, in which 'Fill' function pointer
  * is defined to point on this function.
- * @param[in,out] dest pointer to structure with which memory objects will be
- * swapped
+ * @param[in] pattern pointer to fill color: four floats, four signed or four
+ * unsigned integers, depending on channel data type of Image.
+ * @param[in] pattern_size size of fill color in bytes, must be 16.
+ * @param[in] offset first row to fill.
+ * @param[in] size number of rows to fill. Zero fills Image from offset till
+ * last row.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ * @param[in] explicit_queue command queue. If NULL, queue for Device to Device
+ * transmission of parent Steel Thread is used.
  *
  * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
  *
  * @see cl_err_codes.h for detailed error description.
  * @see 'cl_Error_t' structure for error handling.
  */
-static ret_code Mem_Object_Swap(scow_Mem_Object **self, scow_Mem_Object **dest)
+static ret_code Image_Fill(
+    scow_Mem_Object     *self,
+    const void          *pattern,
+    size_t              pattern_size,
+    size_t              offset,
+    size_t              size,
+    TIME_STUDY_MODE     time_mode,
+    cl_event            *evt_to_generate,
+    cl_command_queue    explicit_queue)
 {
-    scow_Mem_Object* temp;
+    cl_int ret = CL_SUCCESS;
+    cl_event fill_ready, *p_fill_ready = (cl_event*) 0x0;
 
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(pattern, INVALID_BUFFER_GIVEN);
 
-    OCL_CHECK_EXISTENCE(*self, INVALID_BUFFER_GIVEN);
-    OCL_CHECK_EXISTENCE(*dest, INVALID_BUFFER_GIVEN);
+    size_t origin[3] = { 0, 0, 0 }, region[3];
 
-    // Order of conditions is important
-    if ((*self)->obj_mem_type != (*dest)->obj_mem_type)
-    {
-        return DISTINCT_MEM_OBJECTS;
-    }
+    Get_Image_Region(self, region);
 
-    if ((*self)->mem_flags != (*dest)->mem_flags)
+    if (!size && offset < region[1])
     {
-        return DISTINCT_MEM_FLAGS;
+        size = region[1] - offset;
     }
 
-    if ((*self)->size != (*dest)->size)
+    if (pattern_size != 4 * sizeof(cl_uint) || !size ||
+            offset + size > region[1])
     {
         return INVALID_BUFFER_SIZE;
     }
 
-    // No OpenCL Device-side operations are made
-    temp = *self;
-    *self = *dest;
-    *dest = temp;
+    origin[1] = offset;
+    region[1] = size;
 
-    return CL_SUCCESS;
+    (evt_to_generate != NULL) ?
+            (p_fill_ready = evt_to_generate) :
+            (p_fill_ready = &fill_ready);
+
+    cl_command_queue q = (explicit_queue == NULL) ?
+        (self->parent_thread->q_data_dtod) :
+        (explicit_queue);
+
+    ret = clEnqueueFillImage(q, self->cl_mem_object, pattern, origin, region,
+            0, NULL, p_fill_ready);
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    self->timer->Measure_Event(self->timer, p_fill_ready, time_mode);
+
+    if (p_fill_ready != evt_to_generate){
+        clReleaseEvent(*p_fill_ready);
+    }
+
+    return ret;
 }
 
 /**
  * \related cl_Mem_Object_t
- * This function erases the content of Buffer memory via mapping + unmapping. Be
- * careful when using this on OpenCL Device with discrete memory.
+ *
+ * This function erases the content of Memory Object with zeros on Device side
+ * & waits, until it's done.
  *
  * @param[in,out] self  pointer to structure, in which 'Erase' function pointer
  * is defined to point on this function.
@@ -1049,25 +1814,137 @@ static ret_code Mem_Object_Swap(scow_Mem_Object **self, scow_Mem_Object **dest)
  * @see cl_err_codes.h for detailed error description.
  * @see 'cl_Error_t' structure for error handling.
  */
-static ret_code Buffer_Erase(scow_Mem_Object *self)
+static ret_code Mem_Object_Erase(scow_Mem_Object *self)
 {
     OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
 
-    unsigned char *mapped_area = self->Map(self, CL_TRUE, CL_MAP_WRITE,
-            DONT_MEASURE, NULL, NULL);
-
-    ret_code ret = self->error->Get_Last_Code(self->error);
-    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    const cl_uint zeros[4] = { 0, 0, 0, 0 };
+    size_t pattern_size = sizeof(zeros);
+    cl_event erase_ready;
 
-    memset(mapped_area, 0, self->size);
+    // Wider pattern is filled faster, but Buffer size must be multiple of it
+    while (self->obj_mem_type == BUFFER && self->size % pattern_size)
+    {
+        pattern_size /= 2;
+    }
 
-    ret = self->Unmap(self, CL_TRUE, (void**) &mapped_area, DONT_MEASURE, NULL,
-            NULL);
+    ret_code ret = self->Fill(self, zeros, pattern_size, 0, 0, DONT_MEASURE,
+            &erase_ready, NULL);
     OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
 
+    ret = clWaitForEvents(1, &erase_ready);
+    clReleaseEvent(erase_ready);
+
     return ret;
 }
 
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function marks range of Buffer as changed, so that next Sync()
+ * transfers only changed ranges. Ranges, which overlap or are closer than
+ * \ref MEM_OBJECT_DIRTY_GAP, are merged.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Mark_Dirty' function
+ * pointer is defined to point on this function.
+ * @param[in] offset offset of changed range in bytes.
+ * @param[in] size size of changed range in bytes.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ */
+static ret_code Buffer_Mark_Dirty(
+    scow_Mem_Object     *self,
+    size_t              offset,
+    size_t              size)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    if (!size || offset + size > self->size)
+    {
+        return INVALID_BUFFER_SIZE;
+    }
+
+    size_t begin = offset, end = offset + size;
+    size_t granularity = self->dirty_granularity;
+
+    if (granularity > 1)
+    {
+        begin = begin / granularity * granularity;
+        end = (end + granularity - 1) / granularity * granularity;
+        end = (end > self->size) ? self->size : end;
+    }
+
+    // Ranges [first, last) are close enough to be merged with new one
+    cl_uint first = 0, last;
+
+    while (first < self->num_dirty &&
+            self->dirty[first].end + MEM_OBJECT_DIRTY_GAP < begin)
+    {
+        first++;
+    }
+
+    for (last = first; last < self->num_dirty &&
+            self->dirty[last].begin <= end + MEM_OBJECT_DIRTY_GAP; last++)
+    {
+        begin = (self->dirty[last].begin < begin) ?
+                self->dirty[last].begin : begin;
+        end = (self->dirty[last].end > end) ? self->dirty[last].end : end;
+    }
+
+    if (first == last && self->num_dirty == self->max_dirty)
+    {
+        cl_uint max_dirty = self->max_dirty ? 2 * self->max_dirty : 8;
+        Dirty_Range *dirty = (Dirty_Range*) realloc(self->dirty,
+                max_dirty * sizeof(*dirty));
+
+        if (!dirty && !self->dirty)
+        {
+            return BUFFER_NOT_ALLOCATED;
+        }
+
+        // Whole Buffer is dirty then, which needs no more memory
+        if (!dirty)
+        {
+            self->dirty[0].begin = 0;
+            self->dirty[0].end = self->size;
+            self->num_dirty = 1;
+            return CL_SUCCESS;
+        }
+
+        self->dirty = dirty;
+        self->max_dirty = max_dirty;
+    }
+
+    // Merged ranges are replaced by single one, or new one is inserted
+    memmove(&self->dirty[first + 1], &self->dirty[last],
+            (self->num_dirty - last) * sizeof(*self->dirty));
+    self->num_dirty = self->num_dirty + 1 - (last - first);
+
+    self->dirty[first].begin = begin;
+    self->dirty[first].end = end;
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function synchronizes Memory Object, made over Host memory, with its
+ * Host copy. If ranges are marked by Mark_Dirty(), only they are transferred,
+ * otherwise the whole object is.
+ *
+ * @param[in,out] self  pointer to structure, in which 'Sync' function
+ * pointer is defined to point on this function.
+ * @param[in] ethalon side, which has actual data.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise.
+ *
+ * @see cl_err_codes.h for detailed error description.
+ */
 static ret_code Mem_Object_Sync(
     scow_Mem_Object     *self,
     MEM_OBJECT_ETHALON  ethalon,
@@ -1080,6 +1957,30 @@ static ret_code Mem_Object_Sync(
         return INVALID_BUFFER_GIVEN;
     }
 
+    if (self->num_dirty && (ethalon == HOST || ethalon == DEVICE))
+    {
+        for (cl_uint i = 0; i < self->num_dirty && ret == CL_SUCCESS; i++)
+        {
+            size_t offset = self->dirty[i].begin;
+            size_t size = self->dirty[i].end - offset;
+            unsigned char *host = (unsigned char*) self->host_ptr + offset;
+
+            ret = (ethalon == DEVICE) ?
+                    self->Read_Range(self, CL_FALSE, offset, size, host,
+                            time_mode, NULL, NULL) :
+                    self->Write_Range(self, CL_FALSE, offset, size, host,
+                            time_mode, NULL, NULL);
+        }
+
+        // Ranges are kept on failure, so that Sync() may be repeated
+        if (ret == CL_SUCCESS)
+        {
+            self->num_dirty = 0;
+        }
+
+        return ret;
+    }
+
     switch (ethalon){
     case DEVICE:
         self->Read(self, CL_FALSE, self->host_ptr, time_mode, (cl_event*)0, (cl_command_queue)0);
@@ -1097,6 +1998,89 @@ static ret_code Mem_Object_Sync(
     return ret;
 }
 
+/*! \cond PRIVATE */
+static scow_Mem_Object* Buffer_Make_Sub_Buffer(scow_Mem_Object *self,
+        cl_mem_flags flags, cl_buffer_create_type buffer_create_type,
+        const void *buffer_create_info);
+
+/* Function pointers are the same for all objects of the same type, so they
+ * are copied from constant prototype at once. */
+static const scow_Mem_Object buffer_prototype =
+{
+    .obj_mem_type   = BUFFER,
+
+    .Get_Mem_Obj    = Mem_Object_Get_Mem_Obj,
+    .Destroy        = Mem_Object_Destroy,
+    .Swap           = Mem_Object_Swap,
+    .Unmap          = Mem_Object_Unmap,
+
+    .Map            = Buffer_Map,
+    .Write          = Buffer_Send_To_Device,
+    .Read           = Buffer_Get_From_Device,
+    .Copy           = Buffer_Copy,
+    .Map_Range      = Buffer_Map_Range,
+    .Write_Range    = Buffer_Write_Range,
+    .Read_Range     = Buffer_Read_Range,
+    .Copy_Range     = Buffer_Copy_Range,
+    .Write_Rect     = Buffer_Write_Rect,
+    .Read_Rect      = Buffer_Read_Rect,
+    .Copy_Rect      = Buffer_Copy_Rect,
+    .Fill           = Buffer_Fill,
+    .Erase          = Mem_Object_Erase,
+    .Mark_Dirty     = Buffer_Mark_Dirty,
+    .Sync           = Mem_Object_Sync,
+
+    .Get_Height     = Buffer_Get_Height,
+    .Get_Width      = Buffer_Get_Width,
+    .Get_Row_Pitch  = Buffer_Get_Row_Pitch,
+    .Make_Child     = Buffer_Make_Sub_Buffer
+};
+
+static const scow_Mem_Object image_prototype =
+{
+    .obj_mem_type   = IMAGE,
+
+    .Get_Mem_Obj    = Mem_Object_Get_Mem_Obj,
+    .Destroy        = Mem_Object_Destroy,
+    .Swap           = Mem_Object_Swap,
+    .Unmap          = Mem_Object_Unmap,
+
+    .Map            = Image_Map,
+    .Write          = Image_Send_To_Device,
+    .Read           = Image_Get_From_Device,
+    .Copy           = Image_Copy,
+    .Map_Region     = Image_Map_Region,
+    .Write_Region   = Image_Write_Region,
+    .Read_Region    = Image_Read_Region,
+    .Copy_Region    = Image_Copy_Region,
+    .Fill           = Image_Fill,
+    .Erase          = Mem_Object_Erase,
+    .Sync           = Mem_Object_Sync,
+
+    .Get_Height     = Image_Get_Height,
+    .Get_Width      = Image_Get_Width,
+    .Get_Row_Pitch  = Image_Get_Row_Pitch,
+    .Make_Child     = NULL
+};
+
+/* Takes Memory Object from slab of parent Steel Thread instead of separate
+ * allocations for object, its error & timer. */
+static scow_Mem_Object* Alloc_Mem_Object(scow_Steel_Thread *parent_thread,
+        const scow_Mem_Object *prototype)
+{
+    scow_Mem_Object *self = (scow_Mem_Object*) parent_thread->mem_object_slab->
+            Alloc(parent_thread->mem_object_slab);
+    OCL_CHECK_EXISTENCE(self, VOID_MEM_OBJ_PTR);
+
+    *self = *prototype;
+    self->parent_thread = parent_thread;
+    self->error = Init_Error(&self->error_storage);
+    self->timer = Init_Timer(&self->timer_storage, VOID_KERNEL_PTR);
+
+    return self;
+}
+/*! \endcond */
+
 /**
  * \related cl_Mem_Object_t
  *
@@ -1143,33 +2127,21 @@ static scow_Mem_Object* Buffer_Make_Sub_Buffer(scow_Mem_Object *self,
         OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, VOID_MEM_OBJ_PTR);
     }
 
-    child = (scow_Mem_Object*) calloc(1, sizeof(*child));
+    // Alignment is given in bits, origin is given in bytes
+    size_t align = self->parent_thread->device->mem_base_addr_align / 8;
+    if (buffer_create_type == CL_BUFFER_CREATE_TYPE_REGION && align &&
+            ((cl_buffer_region*) buffer_create_info)->origin % align)
+    {
+        ret = SUB_BUFFER_MISALIGNED;
+        self->error->Set_Last_Code(self->error, ret);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, VOID_MEM_OBJ_PTR);
+    }
+
+    child = Alloc_Mem_Object(self->parent_thread, &buffer_prototype);
     OCL_CHECK_EXISTENCE(child, VOID_MEM_OBJ_PTR);
 
-    child->obj_mem_type = BUFFER;
     child->obj_paternity = CHILD_OBJECT;
     child->mem_flags = flags;
-    child->parent_thread = self->parent_thread;
-
-    child->error = Make_Error();
-    child->timer = Make_Timer(VOID_KERNEL_PTR);
-
-    child->Get_Mem_Obj = Mem_Object_Get_Mem_Obj;
-    child->Destroy = Mem_Object_Destroy;
-    child->Swap = Mem_Object_Swap;
-    child->Unmap = Mem_Object_Unmap;
-
-    child->Map = Buffer_Map;
-    child->Write = Buffer_Send_To_Device;
-    child->Read = Buffer_Get_From_Device;
-    child->Copy = Buffer_Copy;
-    child->Erase = Buffer_Erase;
-    child->Sync = Mem_Object_Sync;
-
-    child->Get_Height = Buffer_Get_Height;
-    child->Get_Width = Buffer_Get_Width;
-    child->Get_Row_Pitch = Buffer_Get_Row_Pitch;
-    child->Make_Child = Buffer_Make_Sub_Buffer;
 
     child->cl_mem_object = clCreateSubBuffer(self->cl_mem_object, flags,
             buffer_create_type, buffer_create_info, &ret);
@@ -1184,6 +2156,8 @@ static scow_Mem_Object* Buffer_Make_Sub_Buffer(scow_Mem_Object *self,
         child->host_ptr = (unsigned char*)self->host_ptr + child->origin;
     }
 
+    child->is_zero_copy = self->is_zero_copy;
+
     return child;
 }
 
@@ -1214,40 +2188,73 @@ scow_Mem_Object* Make_Buffer(scow_Steel_Thread *parent_thread,
 
     OCL_CHECK_EXISTENCE(parent_thread, VOID_MEM_OBJ_PTR);
 
-    self = (scow_Mem_Object*) calloc(1, sizeof(*self));
+    self = Alloc_Mem_Object(parent_thread, &buffer_prototype);
     OCL_CHECK_EXISTENCE(self, VOID_MEM_OBJ_PTR);
 
-    self->obj_mem_type = BUFFER;
     self->size = size;
     self->host_ptr = host_ptr;
     self->mem_flags = mem_flags;
-    self->parent_thread = parent_thread;
 
-    self->error = Make_Error();
-    self->timer = Make_Timer(VOID_KERNEL_PTR);
+    /* If Device shares memory with Host, buffer is made over Host memory,
+     * aligned as Device wants it, so that runtime never copies it. */
+    if (parent_thread->zero_copy && !host_ptr && size &&
+            !(mem_flags & CL_MEM_ALLOC_HOST_PTR))
+    {
+        // Alignment is given in bits
+        size_t align = parent_thread->device->mem_base_addr_align / 8;
+        if (align < sizeof(void*))
+        {
+            align = sizeof(void*);
+        }
 
-    self->Get_Mem_Obj = Mem_Object_Get_Mem_Obj;
-    self->Destroy = Mem_Object_Destroy;
-    self->Swap = Mem_Object_Swap;
-    self->Unmap = Mem_Object_Unmap;
+        if (posix_memalign(&self->host_ptr, align,
+                (size + align - 1) / align * align))
+        {
+            self->Destroy(self);
+            return VOID_MEM_OBJ_PTR;
+        }
 
-    self->Map = Buffer_Map;
-    self->Write = Buffer_Send_To_Device;
-    self->Read = Buffer_Get_From_Device;
-    self->Copy = Buffer_Copy;
-    self->Erase = Buffer_Erase;
-    self->Sync = Mem_Object_Sync;
+        self->mem_flags |= CL_MEM_USE_HOST_PTR;
+        self->is_zero_copy = CL_TRUE;
+    }
 
-    self->Get_Height = Buffer_Get_Height;
-    self->Get_Width = Buffer_Get_Width;
-    self->Get_Row_Pitch = Buffer_Get_Row_Pitch;
-    self->Make_Child = Buffer_Make_Sub_Buffer;
+    if (parent_thread->buffer_pool && !self->host_ptr)
+    {
+        self->cl_mem_object = parent_thread->buffer_pool->Acquire(
+                parent_thread->buffer_pool, self->mem_flags, self->size, &ret);
+        self->is_pooled = self->cl_mem_object ? CL_TRUE : CL_FALSE;
+    }
+    else
+    {
+        self->cl_mem_object = clCreateBuffer(self->parent_thread->context,
+                self->mem_flags, self->size, self->host_ptr, &ret);
+    }
 
-    self->cl_mem_object = clCreateBuffer(self->parent_thread->context,
-            self->mem_flags, self->size, self->host_ptr, &ret);
+    if (ret != CL_SUCCESS && self->is_zero_copy)
+    {
+        free(self->host_ptr);
+    }
 
     OCL_DIE_ON_ERROR(ret, CL_SUCCESS, self->Destroy(self), VOID_MEM_OBJ_PTR);
 
+    // Host memory is freed after the last release of OpenCL buffer
+    if (self->is_zero_copy)
+    {
+        ret = clSetMemObjectDestructorCallback(self->cl_mem_object,
+                Free_Host_Memory, self->host_ptr);
+
+        // Without callback memory is freed here, after buffer is released
+        if (ret != CL_SUCCESS)
+        {
+            void *host_ptr = self->host_ptr;
+
+            self->Destroy(self);
+            free(host_ptr);
+
+            return VOID_MEM_OBJ_PTR;
+        }
+    }
+
     return self;
 }
 
@@ -1281,61 +2288,124 @@ scow_Mem_Object* Make_Image(
     const size_t            row_pitch,
     void                    *host_ptr)
 {
-    cl_int ret;
+    cl_image_desc image_desc = {
+        .image_type         = CL_MEM_OBJECT_IMAGE2D,
+        .image_width        = width,
+        .image_height       = height,
+        .image_array_size   = 1,
+        .image_row_pitch    = 0,
+        .image_slice_pitch  = 0,
+        .num_mip_levels     = 0,
+        .num_samples        = 0,
+        .buffer             = NULL
+    };
+
+    return Make_Image_From_Desc(parent_thread, mem_flags, image_format,
+            &image_desc, host_ptr);
+}
+
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function allocates memory for Memory Object with OpenCL image of any
+ * type - 1D, 2D, 3D, 1D or 2D image array, or image over buffer - & sets
+ * function pointers.
+ *
+ * @param[in] parent_thread parent Steel Thread, which gives OpenCL context, etc
+ * @param[in] mem_flags OpenCL memory flags, which will be used for OpenCL
+ * memory objects creation
+ * @param[in] image_format OpenCL image format, that describe characteristics
+ * @param[in] image_desc OpenCL image description: type, sizes & pitches.
+ * @param[in] host_ptr pointer to Host-side memory region (if any). This argument
+ * is optional. If not needed - provide null pointer instead.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated
+ * by this function.
+ */
+scow_Mem_Object* Make_Image_From_Desc(
+    scow_Steel_Thread       *parent_thread,
+    const cl_mem_flags      mem_flags,
+    const cl_image_format   *image_format,
+    const cl_image_desc     *image_desc,
+    void                    *host_ptr)
+{
+    cl_int ret = CL_SUCCESS;
     scow_Mem_Object* self;
 
     OCL_CHECK_EXISTENCE(parent_thread, VOID_MEM_OBJ_PTR);
     OCL_CHECK_EXISTENCE(image_format, VOID_MEM_OBJ_PTR);
+    OCL_CHECK_EXISTENCE(image_desc, VOID_MEM_OBJ_PTR);
 
-    self = (scow_Mem_Object*) calloc(1, sizeof(*self));
+    self = Alloc_Mem_Object(parent_thread, &image_prototype);
     OCL_CHECK_EXISTENCE(self, VOID_MEM_OBJ_PTR);
 
-    self->obj_mem_type = IMAGE;
-    self->parent_thread = parent_thread;
     self->host_ptr = host_ptr;
     self->mem_flags = mem_flags;
-    self->width = width;
-    self->height = height;
+    self->image_type = image_desc->image_type;
+    self->width = image_desc->image_width;
+    self->height = 1;
+    self->depth = 1;
+    self->array_size = 1;
     self->row_pitch = 0;
+    self->slice_pitch = 0;
+
+    // Sizes, which aren't used by image type, are ignored, as OpenCL does
+    switch (self->image_type)
+    {
+    case CL_MEM_OBJECT_IMAGE1D:
+    case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+        break;
+
+    case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+        self->array_size = image_desc->image_array_size;
+        break;
+
+    case CL_MEM_OBJECT_IMAGE2D:
+        self->height = image_desc->image_height;
+        break;
 
-    self->error = Make_Error();
-    self->timer = Make_Timer(VOID_KERNEL_PTR);
+    case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+        self->height = image_desc->image_height;
+        self->array_size = image_desc->image_array_size;
+        break;
 
-    self->Get_Mem_Obj = Mem_Object_Get_Mem_Obj;
-    self->Destroy = Mem_Object_Destroy;
-    self->Swap = Mem_Object_Swap;
-    self->Unmap = Mem_Object_Unmap;
+    case CL_MEM_OBJECT_IMAGE3D:
+        self->height = image_desc->image_height;
+        self->depth = image_desc->image_depth;
+        break;
 
-    self->Map = Image_Map;
-    self->Write = Image_Send_To_Device;
-    self->Read = Image_Get_From_Device;
-    self->Copy = Image_Copy;
-    self->Erase = NULL;
-    self->Sync = Mem_Object_Sync;
+    default:
+        ret = INVALID_ARG_TYPE;
+        break;
+    }
 
-    self->Get_Height = Image_Get_Height;
-    self->Get_Width = Image_Get_Width;
-    self->Get_Row_Pitch = Image_Get_Row_Pitch;
-    self->Make_Child = NULL;
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, self->Destroy(self), VOID_MEM_OBJ_PTR);
 
 #ifdef CL_USE_DEPRECATED_OPENCL_1_1_APIS
-	self->cl_mem_object = clCreateImage2D(self->parent_thread->context,
-            mem_flags, image_format, self->width, self->height, self->row_pitch,
-            host_ptr, &ret);
+    if (self->image_type == CL_MEM_OBJECT_IMAGE2D)
+    {
+        self->cl_mem_object = clCreateImage2D(self->parent_thread->context,
+                mem_flags, image_format, self->width, self->height,
+                image_desc->image_row_pitch, host_ptr, &ret);
+    }
+    else if (self->image_type == CL_MEM_OBJECT_IMAGE3D)
+    {
+        self->cl_mem_object = clCreateImage3D(self->parent_thread->context,
+                mem_flags, image_format, self->width, self->height,
+                self->depth, image_desc->image_row_pitch,
+                image_desc->image_slice_pitch, host_ptr, &ret);
+    }
+    else
+    {
+        // Other image types appeared in OpenCL 1.2
+        ret = INVALID_ARG_TYPE;
+    }
 #else
-    cl_image_desc image_desc = {
-        .image_type         = CL_MEM_OBJECT_IMAGE2D,
-        .image_width        = self->width,
-        .image_height       = self->height,
-        .image_array_size   = 1,
-        .image_row_pitch    = self->row_pitch,
-        .image_slice_pitch  = host_ptr ? (self->row_pitch * self->height) : 0,
-        .num_mip_levels     = 0,
-        .num_samples        = 0,
-        .buffer             = NULL
-    };
     self->cl_mem_object = clCreateImage(self->parent_thread->context,
-        mem_flags, image_format, &image_desc, host_ptr, &ret);
+        mem_flags, image_format, image_desc, host_ptr, &ret);
 #endif
 
     OCL_DIE_ON_ERROR(ret, CL_SUCCESS, self->Destroy(self), VOID_MEM_OBJ_PTR);
@@ -1343,3 +2413,53 @@ scow_Mem_Object* Make_Image(
     return self;
 }
 
+/**
+ * \related cl_Mem_Object_t
+ *
+ * This function allocates memory for Memory Object with 1D OpenCL image, which
+ * aliases given Buffer, & sets function pointers. No data is copied: kernels
+ * get texture access to linear data of Buffer.
+ *
+ * @param[in] buffer Buffer, which holds image data. It must outlive image.
+ * @param[in] mem_flags OpenCL memory flags. Zero takes flags of Buffer.
+ * @param[in] image_format OpenCL image format, that describe characteristics
+ * @param[in] width image width in pixels. Buffer must hold that many pixels.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_MEM_OBJ_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated
+ * by this function.
+ */
+scow_Mem_Object* Make_Image_From_Buffer(
+    scow_Mem_Object         *buffer,
+    const cl_mem_flags      mem_flags,
+    const cl_image_format   *image_format,
+    const size_t            width)
+{
+    OCL_CHECK_EXISTENCE(buffer, VOID_MEM_OBJ_PTR);
+
+    if (buffer->obj_mem_type != BUFFER)
+    {
+        buffer->error->Set_Last_Code(buffer->error, INVALID_ARG_TYPE);
+        return VOID_MEM_OBJ_PTR;
+    }
+
+    cl_image_desc image_desc = {
+        .image_type         = CL_MEM_OBJECT_IMAGE1D_BUFFER,
+        .image_width        = width,
+        .image_height       = 1,
+        .image_depth        = 1,
+        .image_array_size   = 1,
+        .image_row_pitch    = 0,
+        .image_slice_pitch  = 0,
+        .num_mip_levels     = 0,
+        .num_samples        = 0,
+        .buffer             = buffer->cl_mem_object
+    };
+
+    // Host pointer usage flags are inherited from Buffer & can't be given
+    return Make_Image_From_Desc(buffer->parent_thread, mem_flags, image_format,
+            &image_desc, NULL);
+}
+
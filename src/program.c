@@ -0,0 +1,1009 @@
+/*
+ * @file program.c
+ * @brief Provides basic abstraction for OpenCL program, shared by kernels
+ *
+ * @see program.h
+ * @see kernel.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "program.h"
+#include "program_cache.h"
+#include "embedded_il.h"
+#include "steel_thread.h"
+#include "device.h"
+#include "platform.h"
+#include "kernel.h"
+#include "thread_pool.h"
+
+/*! \cond PRIVATE */
+/* File is zero terminated to be used as string. Its size is returned via
+ * 'file_size', if it's given, to be used as binary. */
+static char* Read_Source_File(const char *filename, size_t *file_size)
+{
+    long int size = 0, res = 0;
+
+    char *src = NULL;
+
+    FILE *file = fopen(filename, "rb");
+
+    if (!file)
+        return NULL;
+
+    if (fseek(file, 0, SEEK_END))
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    size = ftell(file);
+    if (size == 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    rewind(file);
+
+    src = (char *) calloc(size + 1, sizeof(char));
+    if (!src)
+    {
+        src = NULL;
+        fclose(file);
+        return src;
+    }
+
+    res = fread(src, 1, sizeof(char) * size, file);
+    if (res != sizeof(char) * size)
+    {
+        fclose(file);
+        free(src);
+
+        return (char*)NULL;
+    }
+
+    src[size] = '\0'; /* NULL terminated */
+    fclose(file);
+
+    if (file_size)
+    {
+        *file_size = (size_t) size;
+    }
+
+    return src;
+}
+
+static void Print_Build_Log(scow_Program *self)
+{
+    size_t len = 0;
+    char *buffer;
+
+    clGetProgramBuildInfo(self->program,
+        self->parent_steel_thread->device->device_id,
+            CL_PROGRAM_BUILD_LOG, 0, NULL, &len);
+
+    buffer = calloc(len + 1, sizeof(char));
+    if (!buffer)
+        return;
+
+    clGetProgramBuildInfo(self->program,
+        self->parent_steel_thread->device->device_id,
+            CL_PROGRAM_BUILD_LOG, len, buffer, NULL);
+
+    error_message(buffer);
+
+    free(buffer);
+}
+
+static ret_code Build_Program(scow_Program *self,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char *src,
+        const char *build_params)
+{
+    ret_code ret = CL_SUCCESS;
+
+    if (how_to_get_sources == READ_FROM_BINARY)
+    {
+        /* Cache miss, stale or rejected binary isn't error - fall back to
+         * build from source. */
+        self->program = Load_Program_Binary(self->parent_steel_thread, src,
+                build_params, &ret);
+
+        if (self->program)
+        {
+            return CL_SUCCESS;
+        }
+    }
+
+    self->program = clCreateProgramWithSource(
+            self->parent_steel_thread->context, 1, &src, NULL, &ret);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, CANT_CREATE_PROGRAM);
+
+    ret = clBuildProgram(self->program, 0, NULL, build_params, NULL, NULL);
+
+    if (ret != CL_SUCCESS)
+    {
+        Print_Build_Log(self);
+        return ret;
+    }
+
+    if (how_to_get_sources == READ_FROM_BINARY)
+    {
+        // Failure to store binary only costs rebuild at next run
+        Store_Program_Binary(self->parent_steel_thread, self->program, src,
+                build_params);
+    }
+
+    return CL_SUCCESS;
+}
+
+/* clCreateProgramWithIL() is core since OpenCL 2.1, older Devices may provide
+ * it via cl_khr_il_program extension. */
+typedef cl_program (CL_API_CALL *Create_Program_With_IL_Fn)(cl_context context,
+        const void *il, size_t length, cl_int *errcode_ret);
+
+static cl_program Create_Program_With_IL(scow_Program *self, const void *il,
+        size_t il_size, ret_code *ret)
+{
+    scow_Steel_Thread *steel_thread = self->parent_steel_thread;
+
+    *ret = IL_NOT_SUPPORTED;
+
+#ifdef CL_VERSION_2_1
+    unsigned int major = 0, minor = 0;
+
+    sscanf(steel_thread->device->device_version, "OpenCL %u.%u", &major,
+            &minor);
+
+    if (major > 2 || (major == 2 && minor >= 1))
+    {
+        return clCreateProgramWithIL(steel_thread->context, il, il_size, ret);
+    }
+#endif
+
+    if (strstr(steel_thread->device->extensions, "cl_khr_il_program"))
+    {
+        Create_Program_With_IL_Fn create = (Create_Program_With_IL_Fn)
+                clGetExtensionFunctionAddressForPlatform(
+                        steel_thread->platform->platform,
+                        "clCreateProgramWithILKHR");
+
+        if (create)
+        {
+            return create(steel_thread->context, il, il_size, ret);
+        }
+    }
+
+    return NULL;
+}
+
+static ret_code Build_From_IL(scow_Program *self, const char *source,
+        const char *build_params)
+{
+    const scow_Embedded_IL *embedded = Find_Embedded_IL(source);
+    char *il_file = NULL;
+    const void *il = NULL;
+    size_t il_size = 0;
+    ret_code ret;
+
+    // Argument 'source' acts as name of embedded program or as filename
+    if (embedded)
+    {
+        il = embedded->il;
+        il_size = embedded->il_size;
+    }
+    else
+    {
+        il_file = Read_Source_File(source, &il_size);
+
+        if (il_file == NULL)
+        {
+            error_message("Error while reading SPIR-V file.\n");
+            return CANT_FIND_KERNEL_SOURCE;
+        }
+
+        il = il_file;
+    }
+
+    self->program = il ? Create_Program_With_IL(self, il, il_size, &ret) : NULL;
+    free(il_file);
+
+    if (self->program)
+    {
+        ret = clBuildProgram(self->program, 0, NULL, build_params, NULL, NULL);
+
+        if (ret != CL_SUCCESS)
+        {
+            Print_Build_Log(self);
+        }
+
+        return ret;
+    }
+
+    // Device can't consume IL, so embedded program is compiled from source
+    if (embedded && embedded->source)
+    {
+        return Build_Program(self, READ_FROM_STRING, embedded->source,
+                build_params);
+    }
+
+    return il ? ret : IL_NOT_SUPPORTED;
+}
+
+// Join init parameters of Steel Thread & extra parameters of program
+static char* Make_Build_Params(scow_Steel_Thread *steel_thread,
+        const char *extra_params)
+{
+    char *build_params = (char*) calloc(
+            strlen(steel_thread->init_params) + strlen(extra_params) + 2,
+            sizeof(*build_params));
+
+    if (build_params)
+    {
+        strcat(build_params, steel_thread->init_params);
+        strcat(build_params, " ");
+        strcat(build_params, extra_params);
+    }
+
+    return build_params;
+}
+
+static ret_code Build_From_Sources(scow_Program *self,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char *source,
+        const char *build_params)
+{
+    ret_code ret;
+    char *src_file;
+
+    switch (how_to_get_sources)
+    {
+    case READ_FROM_FILES:
+    case READ_FROM_BINARY:
+        /* Argument 'source' acts as filename. In case of binary, source is
+         * needed to find cached binary & to rebuild program, if it's stale. */
+        src_file = Read_Source_File(source, NULL);
+
+        if (src_file == NULL)
+        {
+            error_message("Error while reading kernel source file.\n");
+            return CANT_FIND_KERNEL_SOURCE;
+        }
+
+        ret = Build_Program(self, how_to_get_sources, src_file, build_params);
+        free(src_file);
+        break;
+
+    case READ_FROM_STRING:
+        // Argument 'source' acts as string with source code;
+        ret = Build_Program(self, how_to_get_sources, source, build_params);
+        break;
+
+    case READ_FROM_IL:
+        ret = Build_From_IL(self, source, build_params);
+        break;
+
+    default:
+        ret = INVALID_ARG_TYPE;
+        break;
+    }
+
+    return ret;
+}
+
+// Publish result of build & wake up everyone, who waits for it
+static void Finish_Build(scow_Program *self, ret_code ret)
+{
+    pthread_mutex_lock(&self->build_lock);
+
+    self->build_ret = ret;
+    self->build_status = (ret == CL_SUCCESS) ? CL_BUILD_SUCCESS : CL_BUILD_ERROR;
+
+    pthread_cond_broadcast(&self->build_done);
+    pthread_mutex_unlock(&self->build_lock);
+}
+
+// Asynchronous build job owns copies of all strings it needs
+typedef struct Program_Build_Job
+{
+    scow_Program *program;
+    OPENCL_SOURCES_MODE how_to_get_sources;
+    char *source;
+    char *build_params;
+} Program_Build_Job;
+
+static void Program_Build_Job_Run(void *job_arg)
+{
+    Program_Build_Job *job = (Program_Build_Job*) job_arg;
+
+    ret_code ret = Build_From_Sources(job->program, job->how_to_get_sources,
+            job->source, job->build_params);
+
+    scow_Program *program = job->program;
+
+    free(job->source);
+    free(job->build_params);
+    free(job);
+
+    // Program may be freed right after that, so it must be the last access
+    Finish_Build(program, ret);
+}
+
+static char* Copy_String(const char *str)
+{
+    char *copy = (char*) malloc(strlen(str) + 1);
+
+    if (copy)
+    {
+        strcpy(copy, str);
+    }
+
+    return copy;
+}
+
+// Exclude program from list of programs of parent Steel Thread (if it's there)
+static void Unlink_Program(scow_Program *self)
+{
+    pthread_mutex_lock(&self->parent_steel_thread->programs_lock);
+
+    scow_Program **p_curr = &self->parent_steel_thread->programs;
+
+    while (*p_curr)
+    {
+        if (*p_curr == self)
+        {
+            *p_curr = self->next;
+            break;
+        }
+
+        p_curr = &(*p_curr)->next;
+    }
+
+    self->next = NULL;
+
+    pthread_mutex_unlock(&self->parent_steel_thread->programs_lock);
+}
+/*! \endcond */
+
+/**
+ * \related scow_Program
+ *
+ * This function releases one reference to program. When last reference is
+ * released, it releases OpenCL program & frees allocated memory.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Program', in which
+ * function pointer 'Destroy' is defined to point on this function
+
+ * @return CL_SUCCESS always
+ */
+static ret_code Program_Destroy(scow_Program *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    // Kernels, made from program, may be released by different Host threads
+    if (__atomic_sub_fetch(&self->ref_count, 1, __ATOMIC_ACQ_REL) > 0)
+    {
+        return CL_SUCCESS;
+    }
+
+    // Build worker still refers program, so let it finish
+    self->Wait_Build(self);
+
+    Unlink_Program(self);
+
+    pthread_cond_destroy(&self->build_done);
+    pthread_mutex_destroy(&self->build_lock);
+
+    if (self->program)
+    {
+        clReleaseProgram(self->program);
+    }
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function waits until program is built. It returns immediately for
+ * programs, made by Make_Program().
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Program', in which
+ * function pointer 'Wait_Build' is defined to point on this function
+
+ * @return CL_SUCCESS if program is built successfully, error code of type
+ * ret_code otherwise.
+ */
+static ret_code Program_Wait_Build(scow_Program *self)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    pthread_mutex_lock(&self->build_lock);
+
+    while (self->build_status == CL_BUILD_IN_PROGRESS)
+    {
+        pthread_cond_wait(&self->build_done, &self->build_lock);
+    }
+
+    ret_code ret = self->build_ret;
+
+    pthread_mutex_unlock(&self->build_lock);
+
+    return ret;
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function returns build status of program without waiting.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Program', in which
+ * function pointer 'Get_Build_Status' is defined to point on this function
+
+ * @return CL_BUILD_IN_PROGRESS, CL_BUILD_SUCCESS or CL_BUILD_ERROR.
+ */
+static cl_build_status Program_Get_Build_Status(scow_Program *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_BUILD_ERROR);
+
+    pthread_mutex_lock(&self->build_lock);
+    cl_build_status status = self->build_status;
+    pthread_mutex_unlock(&self->build_lock);
+
+    return status;
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function acquires one more reference to program.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Program', in which
+ * function pointer 'Retain' is defined to point on this function
+
+ * @return pointer to program, that must be released by 'Destroy' later.
+ */
+static scow_Program* Program_Retain(scow_Program *self)
+{
+    OCL_CHECK_EXISTENCE(self, VOID_PROGRAM_PTR);
+
+    __atomic_add_fetch(&self->ref_count, 1, __ATOMIC_RELAXED);
+
+    return self;
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function makes kernel with given name from program. If program is
+ * still being built, OpenCL kernel is created at first use of kernel.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Program', in which
+ * function pointer 'Get_Kernel' is defined to point on this function
+ * @param[in] kernel_name name of OpenCL kernel
+
+ * @return pointer to allocated kernel in case of success,
+ * \ref VOID_KERNEL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer of kernel to free memory,
+ * allocated by this function.
+ */
+static scow_Kernel* Program_Get_Kernel(scow_Program *self,
+        const char *kernel_name)
+{
+    OCL_CHECK_EXISTENCE(self, VOID_KERNEL_PTR);
+
+    return Make_Kernel_From_Program(self, kernel_name, (cl_kernel) 0x0);
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function makes kernels for all kernel functions in program via
+ * clCreateKernelsInProgram(). If program is built asynchronously, function
+ * waits for build to finish.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Program', in which
+ * function pointer 'Get_All_Kernels' is defined to point on this function
+ * @param[out] num_kernels number of kernels made.
+
+ * @return array of pointers to allocated kernels in case of success, NULL
+ * pointer otherwise. In case of fail, function sets value of error code into
+ * structure, defined by pointer 'self->error'.
+ *
+ * @warning always use 'Destroy' function pointer of each kernel to free memory,
+ * allocated for kernels & free() to free memory allocated for array.
+ */
+static scow_Kernel** Program_Get_All_Kernels(scow_Program *self,
+        cl_uint *num_kernels)
+{
+    OCL_CHECK_EXISTENCE(self, NULL);
+    OCL_CHECK_EXISTENCE(num_kernels, NULL);
+
+    cl_uint num = 0;
+    *num_kernels = 0;
+
+    ret_code ret = self->Wait_Build(self);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS,
+            self->error->Set_Last_Code(self->error, ret), NULL);
+
+    ret = clCreateKernelsInProgram(self->program, 0, NULL, &num);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS,
+            self->error->Set_Last_Code(self->error, ret), NULL);
+
+    if (num == 0)
+    {
+        self->error->Set_Last_Code(self->error, KERNEL_DOESNT_EXIST);
+        return NULL;
+    }
+
+    cl_kernel *cl_kernels = (cl_kernel*) calloc(num, sizeof(*cl_kernels));
+    scow_Kernel **kernels = (scow_Kernel**) calloc(num, sizeof(*kernels));
+
+    if (!cl_kernels || !kernels)
+    {
+        free(cl_kernels);
+        free(kernels);
+        self->error->Set_Last_Code(self->error, BUFFER_NOT_ALLOCATED);
+        return NULL;
+    }
+
+    ret = clCreateKernelsInProgram(self->program, num, cl_kernels, NULL);
+
+    if (ret != CL_SUCCESS)
+    {
+        free(cl_kernels);
+        free(kernels);
+        self->error->Set_Last_Code(self->error, ret);
+        return NULL;
+    }
+
+    for (cl_uint i = 0; i < num; i++)
+    {
+        char name[OCL_KERNEL_NAME_MAX_LEN] = { 0 };
+
+        clGetKernelInfo(cl_kernels[i], CL_KERNEL_FUNCTION_NAME, sizeof(name),
+                name, NULL);
+
+        // Kernel wrapper takes ownership of OpenCL kernel, even if it fails
+        kernels[i] = Make_Kernel_From_Program(self, name, cl_kernels[i]);
+
+        if (!kernels[i])
+        {
+            for (cl_uint j = 0; j < i; j++)
+            {
+                kernels[j]->Destroy(kernels[j]);
+            }
+
+            for (cl_uint j = i + 1; j < num; j++)
+            {
+                clReleaseKernel(cl_kernels[j]);
+            }
+
+            free(cl_kernels);
+            free(kernels);
+            self->error->Set_Last_Code(self->error, KERNEL_DOESNT_EXIST);
+            return NULL;
+        }
+    }
+
+    free(cl_kernels);
+    *num_kernels = num;
+
+    return kernels;
+}
+
+/*! \cond PRIVATE */
+static scow_Program* Alloc_Program(scow_Steel_Thread *parent_steel_thread)
+{
+    scow_Program *self = (scow_Program*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_PROGRAM_PTR);
+
+    self->Destroy = Program_Destroy;
+    self->Retain = Program_Retain;
+    self->Wait_Build = Program_Wait_Build;
+    self->Get_Build_Status = Program_Get_Build_Status;
+    self->Get_Kernel = Program_Get_Kernel;
+    self->Get_All_Kernels = Program_Get_All_Kernels;
+
+    self->parent_steel_thread = parent_steel_thread;
+    self->error = Make_Error();
+    self->ref_count = 1;
+    self->build_status = CL_BUILD_IN_PROGRESS;
+
+    pthread_mutex_init(&self->build_lock, NULL);
+    pthread_cond_init(&self->build_done, NULL);
+
+    return self;
+}
+
+// Register program within parent Steel Thread, which list must be locked
+static void Link_Program_Locked(scow_Program *self)
+{
+    self->next = self->parent_steel_thread->programs;
+    self->parent_steel_thread->programs = self;
+}
+
+static void Link_Program(scow_Program *self)
+{
+    pthread_mutex_lock(&self->parent_steel_thread->programs_lock);
+    Link_Program_Locked(self);
+    pthread_mutex_unlock(&self->parent_steel_thread->programs_lock);
+}
+
+/* Program, which last reference is being released, is still in list until it
+ * unlinks itself, so it's retained only if it's alive. List must be locked. */
+static scow_Program* Find_Variant_Locked(scow_Steel_Thread *steel_thread,
+        cl_ulong variant_key)
+{
+    for (scow_Program *curr = steel_thread->programs; curr; curr = curr->next)
+    {
+        if (curr->variant_key != variant_key)
+        {
+            continue;
+        }
+
+        cl_uint count = __atomic_load_n(&curr->ref_count, __ATOMIC_RELAXED);
+
+        while (count > 0)
+        {
+            if (__atomic_compare_exchange_n(&curr->ref_count, &count,
+                    count + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            {
+                return curr;
+            }
+        }
+    }
+
+    return VOID_PROGRAM_PTR;
+}
+
+static int Compare_Defines(const void *a, const void *b)
+{
+    return strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+/* Defines are sorted & duplicates are dropped, so that same set of constants
+ * gives same build options regardless of order. */
+static char* Make_Define_Params(cl_uint num_defines, const char **defines)
+{
+    const char **sorted = (const char**) malloc(
+            (num_defines ? num_defines : 1) * sizeof(*sorted));
+    OCL_CHECK_EXISTENCE(sorted, NULL);
+
+    size_t length = 1;
+
+    for (cl_uint i = 0; i < num_defines; i++)
+    {
+        if (!defines[i])
+        {
+            free(sorted);
+            return NULL;
+        }
+
+        sorted[i] = defines[i];
+        length += strlen(defines[i]) + sizeof("-D  ");
+    }
+
+    qsort(sorted, num_defines, sizeof(*sorted), Compare_Defines);
+
+    char *params = (char*) calloc(length, sizeof(*params));
+
+    if (params)
+    {
+        for (cl_uint i = 0; i < num_defines; i++)
+        {
+            if (i > 0 && strcmp(sorted[i], sorted[i - 1]) == 0)
+            {
+                continue;
+            }
+
+            strcat(params, (i > 0) ? " -D " : "-D ");
+            strcat(params, sorted[i]);
+        }
+    }
+
+    free(sorted);
+
+    return params;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Program
+ *
+ * This function allocates memory for structure, sets function pointers,
+ * creates & builds OpenCL program.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * program source is provided
+ * @param[in] source this argument can either be filename, if program source is
+ * provided in file (pre-built program is looked up in binary cache by that
+ * source), or it's a string with source code
+ * @param[in] extra_params extra parameters, that will be used during programm
+ * building stage. This argument is optional, pass NULL if not needed.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_PROGRAM_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to release reference,
+ * obtained from this function.
+ */
+scow_Program* Make_Program(scow_Steel_Thread *parent_steel_thread,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char *source,
+        const char *extra_params)
+{
+    scow_Program *self;
+    ret_code ret;
+
+    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_PROGRAM_PTR);
+    OCL_CHECK_EXISTENCE(source, VOID_PROGRAM_PTR);
+
+    if (!extra_params)
+    {
+        extra_params = "";
+    }
+
+    self = Alloc_Program(parent_steel_thread);
+    OCL_CHECK_EXISTENCE(self, VOID_PROGRAM_PTR);
+
+    char *build_params = Make_Build_Params(parent_steel_thread, extra_params);
+
+    if (build_params)
+    {
+        ret = Build_From_Sources(self, how_to_get_sources, source,
+                build_params);
+        free(build_params);
+    }
+    else
+    {
+        ret = BUFFER_NOT_ALLOCATED;
+    }
+
+    Finish_Build(self, ret);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, self->Destroy(self), VOID_PROGRAM_PTR);
+
+    Link_Program(self);
+
+    return self;
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function allocates memory for structure, sets function pointers &
+ * submits OpenCL program build to worker threads of parent Steel Thread.
+ * It returns without waiting for build to finish, so that many programs can
+ * be built in parallel.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * program source is provided
+ * @param[in] source this argument can either be filename, if program source is
+ * provided in file (pre-built program is looked up in binary cache by that
+ * source), or it's a string with source code. String is copied, so it may be
+ * freed right after call.
+ * @param[in] extra_params extra parameters, that will be used during programm
+ * building stage. This argument is optional, pass NULL if not needed.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_PROGRAM_PTR otherwise. Use 'Wait_Build' function pointer to get
+ * result of build.
+ *
+ * @warning always use 'Destroy' function pointer to release reference,
+ * obtained from this function.
+ */
+scow_Program* Make_Program_Async(scow_Steel_Thread *parent_steel_thread,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char *source,
+        const char *extra_params)
+{
+    scow_Program *self;
+    Program_Build_Job *job;
+    ret_code ret;
+
+    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_PROGRAM_PTR);
+    OCL_CHECK_EXISTENCE(source, VOID_PROGRAM_PTR);
+
+    if (!extra_params)
+    {
+        extra_params = "";
+    }
+
+    /* Worker threads are started at first asynchronous build. Lock keeps
+     * concurrent first builds from starting two pools. */
+    pthread_mutex_lock(&parent_steel_thread->programs_lock);
+    if (!parent_steel_thread->build_pool)
+    {
+        parent_steel_thread->build_pool = Make_Thread_Pool(0);
+    }
+    pthread_mutex_unlock(&parent_steel_thread->programs_lock);
+    OCL_CHECK_EXISTENCE(parent_steel_thread->build_pool, VOID_PROGRAM_PTR);
+
+    job = (Program_Build_Job*) calloc(1, sizeof(*job));
+    OCL_CHECK_EXISTENCE(job, VOID_PROGRAM_PTR);
+
+    job->how_to_get_sources = how_to_get_sources;
+    job->source = Copy_String(source);
+    job->build_params = Make_Build_Params(parent_steel_thread, extra_params);
+    job->program = Alloc_Program(parent_steel_thread);
+
+    if (!job->source || !job->build_params || !job->program)
+    {
+        if (job->program)
+        {
+            Finish_Build(job->program, BUFFER_NOT_ALLOCATED);
+            job->program->Destroy(job->program);
+        }
+
+        free(job->source);
+        free(job->build_params);
+        free(job);
+
+        return VOID_PROGRAM_PTR;
+    }
+
+    self = job->program;
+
+    ret = parent_steel_thread->build_pool->Submit(
+            parent_steel_thread->build_pool, Program_Build_Job_Run, job);
+
+    if (ret != CL_SUCCESS)
+    {
+        free(job->source);
+        free(job->build_params);
+        free(job);
+
+        Finish_Build(self, ret);
+        self->Destroy(self);
+
+        return VOID_PROGRAM_PTR;
+    }
+
+    /* Program is registered right away, so that Steel Thread waits for it
+     * at destruction even if build isn't finished yet. */
+    Link_Program(self);
+
+    return self;
+}
+
+/**
+ * \related scow_Program
+ *
+ * This function returns program, which is built from given source with given
+ * constants defined. If such variant was already made under parent Steel
+ * Thread & is still alive, it's shared instead of building new one.
+ *
+ * Variant is registered before it's built, so concurrent requests of the same
+ * variant share single build: they get program, which build is in progress,
+ * & wait for it at first use.
+ *
+ * @param[in] parent_steel_thread parent Steel Thread, which gives context, etc
+ * @param[in] how_to_get_sources enumeration, that describes in what way
+ * program source is provided. With READ_FROM_BINARY variant is looked up in
+ * on-disk binary cache as well, if it isn't made in this process yet.
+ * @param[in] source this argument can either be filename, if program source is
+ * provided in file, or it's a string with source code
+ * @param[in] num_defines number of constants.
+ * @param[in] defines array of constants in form "NAME" or "NAME=VALUE". Order
+ * doesn't matter, each constant is passed to compiler as -D option.
+ *
+ * @return pointer to allocated or shared structure in case of success,
+ * \ref VOID_PROGRAM_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to release reference,
+ * obtained from this function.
+ */
+scow_Program* Make_Program_Variant(scow_Steel_Thread *parent_steel_thread,
+        OPENCL_SOURCES_MODE how_to_get_sources, const char *source,
+        cl_uint num_defines, const char **defines)
+{
+    scow_Program *self;
+    char *src_file = NULL;
+    const char *src = source;
+    ret_code ret;
+
+    OCL_CHECK_EXISTENCE(parent_steel_thread, VOID_PROGRAM_PTR);
+    OCL_CHECK_EXISTENCE(source, VOID_PROGRAM_PTR);
+
+    if (num_defines > 0 && !defines)
+    {
+        return VOID_PROGRAM_PTR;
+    }
+
+    // Source text is part of variant key, so file is read once here
+    if (how_to_get_sources == READ_FROM_FILES
+            || how_to_get_sources == READ_FROM_BINARY)
+    {
+        src_file = Read_Source_File(source, NULL);
+
+        if (src_file == NULL)
+        {
+            error_message("Error while reading kernel source file.\n");
+            return VOID_PROGRAM_PTR;
+        }
+
+        src = src_file;
+    }
+    else if (how_to_get_sources != READ_FROM_STRING)
+    {
+        return VOID_PROGRAM_PTR;
+    }
+
+    char *define_params = Make_Define_Params(num_defines, defines);
+    char *build_params = define_params ?
+            Make_Build_Params(parent_steel_thread, define_params) : NULL;
+
+    free(define_params);
+
+    if (!build_params)
+    {
+        free(src_file);
+        return VOID_PROGRAM_PTR;
+    }
+
+    cl_ulong variant_key = Get_Program_Key(src, build_params);
+    cl_bool is_new = CL_FALSE;
+
+    pthread_mutex_lock(&parent_steel_thread->programs_lock);
+
+    self = Find_Variant_Locked(parent_steel_thread, variant_key);
+
+    if (!self)
+    {
+        self = Alloc_Program(parent_steel_thread);
+
+        if (self)
+        {
+            self->variant_key = variant_key;
+            Link_Program_Locked(self);
+            is_new = CL_TRUE;
+        }
+    }
+
+    pthread_mutex_unlock(&parent_steel_thread->programs_lock);
+
+    if (is_new)
+    {
+        ret = Build_Program(self, how_to_get_sources, src, build_params);
+
+        if (ret != CL_SUCCESS)
+        {
+            // Failed variant isn't shared anymore, so next request rebuilds it
+            pthread_mutex_lock(&parent_steel_thread->programs_lock);
+            self->variant_key = 0;
+            pthread_mutex_unlock(&parent_steel_thread->programs_lock);
+        }
+
+        Finish_Build(self, ret);
+
+        if (ret != CL_SUCCESS)
+        {
+            self->Destroy(self);
+            self = VOID_PROGRAM_PTR;
+        }
+    }
+
+    free(build_params);
+    free(src_file);
+
+    return self;
+}
@@ -0,0 +1,352 @@
+/*
+ * @file program_cache.c
+ * @brief Persistent on-disk cache of built OpenCL program binaries & tuned
+ * kernel parameters
+ *
+ * @see program_cache.h
+ * @see kernel.c
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "program_cache.h"
+#include "steel_thread.h"
+#include "device.h"
+#include "error.h"
+
+/*! \cond PRIVATE */
+#undef BINARY_CACHE_MAGIC
+#define BINARY_CACHE_MAGIC          "SCOWBIN"
+
+#undef FNV_OFFSET_BASIS
+#define FNV_OFFSET_BASIS            (0xcbf29ce484222325ULL)
+
+#undef FNV_PRIME
+#define FNV_PRIME                   (0x100000001b3ULL)
+
+// Header, which precedes program binary in cache file
+typedef struct Binary_Cache_Header
+{
+    char magic[8];
+    cl_ulong key;
+    cl_ulong binary_size;
+} Binary_Cache_Header;
+
+/* FNV-1a hash. Terminating zero is hashed as well, so that boundaries between
+ * key components matter. */
+static cl_ulong Hash_String(cl_ulong hash, const char *str)
+{
+    const unsigned char *p = (const unsigned char*) (str ? str : "");
+
+    do
+    {
+        hash ^= *p;
+        hash *= FNV_PRIME;
+    } while (*p++);
+
+    return hash;
+}
+
+static cl_ulong Get_Cache_Key(scow_Steel_Thread *steel_thread,
+        const char *source, const char *build_params)
+{
+    cl_ulong key = FNV_OFFSET_BASIS;
+
+    key = Hash_String(key, source);
+    key = Hash_String(key, build_params);
+    key = Hash_String(key, steel_thread->device->name);
+    key = Hash_String(key, steel_thread->device->driver_version);
+
+    return key;
+}
+
+static void Get_Cache_File_Name(scow_Steel_Thread *steel_thread, cl_ulong key,
+        char *file_name, size_t file_name_size)
+{
+    snprintf(file_name, file_name_size, "%s/scow_%016llx.bin",
+            steel_thread->binary_cache_dir, (unsigned long long) key);
+}
+
+static cl_ulong Get_Tuning_Key(scow_Steel_Thread *steel_thread,
+        const char *kernel_name, cl_uint dimensionality,
+        const size_t *global_size)
+{
+    char size_class[64];
+    cl_uint log2_size[3] = { 0, 0, 0 };
+
+    for (cl_uint i = 0; i < dimensionality && i < 3; i++)
+    {
+        while (((size_t) 1 << log2_size[i]) < global_size[i])
+        {
+            log2_size[i]++;
+        }
+    }
+
+    snprintf(size_class, sizeof(size_class), "%u:%u:%u:%u", dimensionality,
+            log2_size[0], log2_size[1], log2_size[2]);
+
+    cl_ulong key = FNV_OFFSET_BASIS;
+
+    key = Hash_String(key, kernel_name);
+    key = Hash_String(key, size_class);
+    key = Hash_String(key, steel_thread->device->name);
+    key = Hash_String(key, steel_thread->device->driver_version);
+
+    return key;
+}
+
+static void Get_Tuning_DB_File_Name(scow_Steel_Thread *steel_thread,
+        char *file_name, size_t file_name_size)
+{
+    snprintf(file_name, file_name_size, "%s/%s",
+            steel_thread->binary_cache_dir, SCOW_TUNING_DB_FILE_NAME);
+}
+/*! \endcond */
+
+cl_ulong Get_Program_Key(
+    const char          *source,
+    const char          *build_params)
+{
+    cl_ulong key = FNV_OFFSET_BASIS;
+
+    key = Hash_String(key, source);
+    key = Hash_String(key, build_params);
+
+    // Zero is reserved for programs, which have no key
+    return key ? key : FNV_OFFSET_BASIS;
+}
+
+cl_program Load_Program_Binary(
+    scow_Steel_Thread   *steel_thread,
+    const char          *source,
+    const char          *build_params,
+    ret_code            *ret)
+{
+    OCL_CHECK_EXISTENCE(ret, NULL);
+    *ret = INVALID_BUFFER_GIVEN;
+
+    OCL_CHECK_EXISTENCE(steel_thread, NULL);
+    OCL_CHECK_EXISTENCE(source, NULL);
+
+    char file_name[2 * CL_KERNEL_FILE_NAME_SIZE];
+    cl_ulong key = Get_Cache_Key(steel_thread, source, build_params);
+    Get_Cache_File_Name(steel_thread, key, file_name, sizeof(file_name));
+
+    // Cache miss is no error, caller will build program from source
+    *ret = CANT_ACCESS_BINARY_CACHE;
+
+    FILE *file = fopen(file_name, "rb");
+    OCL_CHECK_EXISTENCE(file, NULL);
+
+    Binary_Cache_Header header;
+
+    if (fread(&header, sizeof(header), 1, file) != 1
+            || memcmp(header.magic, BINARY_CACHE_MAGIC, sizeof(header.magic)) != 0
+            || header.key != key || header.binary_size == 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    size_t binary_size = (size_t) header.binary_size;
+    unsigned char *binary = (unsigned char*) malloc(binary_size);
+
+    if (!binary || fread(binary, 1, binary_size, file) != binary_size)
+    {
+        free(binary);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+
+    cl_int binary_status = CL_SUCCESS;
+    cl_program program = clCreateProgramWithBinary(steel_thread->context, 1,
+            &steel_thread->device->device_id, &binary_size,
+            (const unsigned char**) &binary, &binary_status, ret);
+
+    free(binary);
+
+    if (*ret != CL_SUCCESS || binary_status != CL_SUCCESS)
+    {
+        if (program)
+        {
+            clReleaseProgram(program);
+        }
+
+        *ret = CL_INVALID_BINARY;
+        return NULL;
+    }
+
+    // Binary may still be rejected at build stage (e. g. driver was updated)
+    *ret = clBuildProgram(program, 1, &steel_thread->device->device_id,
+            build_params, NULL, NULL);
+
+    if (*ret != CL_SUCCESS)
+    {
+        clReleaseProgram(program);
+        return NULL;
+    }
+
+    return program;
+}
+
+ret_code Store_Program_Binary(
+    scow_Steel_Thread   *steel_thread,
+    cl_program          program,
+    const char          *source,
+    const char          *build_params)
+{
+    ret_code ret = CL_SUCCESS;
+
+    OCL_CHECK_EXISTENCE(steel_thread, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(program, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(source, INVALID_BUFFER_GIVEN);
+
+    // Program is built for single Device of Steel Thread
+    size_t binary_size = 0;
+
+    ret = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t),
+            &binary_size, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    if (binary_size == 0)
+    {
+        return CANT_ACCESS_BINARY_CACHE;
+    }
+
+    unsigned char *binary = (unsigned char*) malloc(binary_size);
+    OCL_CHECK_EXISTENCE(binary, BUFFER_NOT_ALLOCATED);
+
+    ret = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binary),
+            &binary, NULL);
+    if (ret != CL_SUCCESS)
+    {
+        free(binary);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+    }
+
+    Binary_Cache_Header header;
+    memset(&header, 0, sizeof(header));
+    strcpy(header.magic, BINARY_CACHE_MAGIC);
+    header.key = Get_Cache_Key(steel_thread, source, build_params);
+    header.binary_size = binary_size;
+
+    char file_name[2 * CL_KERNEL_FILE_NAME_SIZE],
+        tmp_file_name[2 * CL_KERNEL_FILE_NAME_SIZE + 32];
+
+    /* Same program may be built by several Host threads simultaneously, so
+     * each of them writes its own temporary file. */
+    Get_Cache_File_Name(steel_thread, header.key, file_name, sizeof(file_name));
+    snprintf(tmp_file_name, sizeof(tmp_file_name), "%s.%p.tmp", file_name,
+            (void*) program);
+
+    FILE *file = fopen(tmp_file_name, "wb");
+
+    if (!file)
+    {
+        free(binary);
+        return CANT_ACCESS_BINARY_CACHE;
+    }
+
+    int written = (fwrite(&header, sizeof(header), 1, file) == 1)
+            && (fwrite(binary, 1, binary_size, file) == binary_size);
+
+    written = (fclose(file) == 0) && written;
+    free(binary);
+
+    if (!written || rename(tmp_file_name, file_name) != 0)
+    {
+        remove(tmp_file_name);
+        return CANT_ACCESS_BINARY_CACHE;
+    }
+
+    return CL_SUCCESS;
+}
+
+ret_code Load_Tuned_Local_Size(
+    scow_Steel_Thread   *steel_thread,
+    const char          *kernel_name,
+    cl_uint             dimensionality,
+    const size_t        *global_size,
+    size_t              *local_size)
+{
+    OCL_CHECK_EXISTENCE(steel_thread, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(kernel_name, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(global_size, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(local_size, INVALID_BUFFER_GIVEN);
+
+    char file_name[2 * CL_KERNEL_FILE_NAME_SIZE];
+    Get_Tuning_DB_File_Name(steel_thread, file_name, sizeof(file_name));
+
+    FILE *file = fopen(file_name, "r");
+    OCL_CHECK_EXISTENCE(file, ARG_NOT_FOUND);
+
+    cl_ulong key = Get_Tuning_Key(steel_thread, kernel_name, dimensionality,
+            global_size);
+
+    unsigned long long entry_key;
+    size_t entry_local[3];
+    ret_code ret = ARG_NOT_FOUND;
+
+    // Database is appended only, so the last entry is the most recent one
+    while (fscanf(file, "%llx %zu %zu %zu", &entry_key, &entry_local[0],
+            &entry_local[1], &entry_local[2]) == 4)
+    {
+        if (entry_key == key)
+        {
+            memcpy(local_size, entry_local, sizeof(entry_local));
+            ret = CL_SUCCESS;
+        }
+    }
+
+    fclose(file);
+
+    return ret;
+}
+
+ret_code Store_Tuned_Local_Size(
+    scow_Steel_Thread   *steel_thread,
+    const char          *kernel_name,
+    cl_uint             dimensionality,
+    const size_t        *global_size,
+    const size_t        *local_size)
+{
+    OCL_CHECK_EXISTENCE(steel_thread, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(kernel_name, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(global_size, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(local_size, INVALID_BUFFER_GIVEN);
+
+    char file_name[2 * CL_KERNEL_FILE_NAME_SIZE];
+    Get_Tuning_DB_File_Name(steel_thread, file_name, sizeof(file_name));
+
+    FILE *file = fopen(file_name, "a");
+    OCL_CHECK_EXISTENCE(file, CANT_ACCESS_BINARY_CACHE);
+
+    cl_ulong key = Get_Tuning_Key(steel_thread, kernel_name, dimensionality,
+            global_size);
+
+    // Entry is written by single call, so that concurrent appends don't mix
+    char entry[128];
+    int len = snprintf(entry, sizeof(entry), "%016llx %zu %zu %zu\n",
+            (unsigned long long) key, local_size[0],
+            (dimensionality > 1) ? local_size[1] : (size_t) 0,
+            (dimensionality > 2) ? local_size[2] : (size_t) 0);
+
+    int written = (fwrite(entry, 1, (size_t) len, file) == (size_t) len);
+    written = (fclose(file) == 0) && written;
+
+    return written ? CL_SUCCESS : CANT_ACCESS_BINARY_CACHE;
+}
@@ -0,0 +1,188 @@
+/*
+ * @file slab.c
+ * @brief Provides allocator of fixed-size objects, carved out of large chunks
+ *
+ * @see slab.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "slab.h"
+#include "error.h"
+
+/*! \cond PRIVATE */
+/* Chunk starts with link to next chunk, padded to alignment. Free object
+ * starts with link to next free object. */
+static void** Link_Of(void *ptr)
+{
+    return (void**) ptr;
+}
+
+// Carves new chunk into free objects. Lock must be held.
+static ret_code Add_Chunk(scow_Slab *self)
+{
+    unsigned char *chunk = (unsigned char*) malloc(SLAB_ALIGNMENT +
+            self->object_size * self->objects_per_chunk);
+    OCL_CHECK_EXISTENCE(chunk, BUFFER_NOT_ALLOCATED);
+
+    *Link_Of(chunk) = self->chunks;
+    self->chunks = chunk;
+    self->num_chunks++;
+
+    for (cl_uint i = self->objects_per_chunk; i-- > 0;)
+    {
+        void *object = chunk + SLAB_ALIGNMENT + i * self->object_size;
+
+        *Link_Of(object) = self->free_list;
+        self->free_list = object;
+    }
+
+    return CL_SUCCESS;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Slab
+ *
+ * This function takes object from free list. New chunk is allocated, if free
+ * list is empty.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Slab', in which
+ * function pointer 'Alloc' is defined to point on this function.
+ *
+ * @return pointer to zero-filled object in case of success, NULL otherwise.
+ */
+static void* Slab_Alloc(scow_Slab *self)
+{
+    OCL_CHECK_EXISTENCE(self, NULL);
+
+    void *object = NULL;
+
+    pthread_mutex_lock(&self->lock);
+
+    if (self->free_list || Add_Chunk(self) == CL_SUCCESS)
+    {
+        object = self->free_list;
+        self->free_list = *Link_Of(object);
+        self->num_live++;
+    }
+
+    pthread_mutex_unlock(&self->lock);
+
+    if (object)
+    {
+        memset(object, 0, self->object_size);
+    }
+
+    return object;
+}
+
+/**
+ * \related scow_Slab
+ *
+ * This function returns object to free list.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Slab', in which
+ * function pointer 'Free' is defined to point on this function.
+ * @param[in] object object, allocated by this slab.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Slab_Free(scow_Slab *self, void *object)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(object, INVALID_BUFFER_GIVEN);
+
+    pthread_mutex_lock(&self->lock);
+
+    *Link_Of(object) = self->free_list;
+    self->free_list = object;
+    self->num_live--;
+
+    pthread_mutex_unlock(&self->lock);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Slab
+ *
+ * This function frees all chunks & memory, allocated for structure.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Slab', in which
+ * function pointer 'Destroy' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Slab_Destroy(scow_Slab *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    while (self->chunks)
+    {
+        void *chunk = self->chunks;
+
+        self->chunks = *Link_Of(chunk);
+        free(chunk);
+    }
+
+    pthread_mutex_destroy(&self->lock);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Slab
+ *
+ * This function allocates memory for structure & sets function pointers.
+ * No chunk is allocated until first object is requested.
+ *
+ * @param[in] object_size size of object in bytes.
+ * @param[in] objects_per_chunk number of objects, allocated at once. Zero
+ * takes \ref SLAB_OBJECTS_PER_CHUNK.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_SLAB_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. All objects must be freed before.
+ */
+scow_Slab* Make_Slab(size_t object_size, cl_uint objects_per_chunk)
+{
+    if (!object_size)
+    {
+        return VOID_SLAB_PTR;
+    }
+
+    scow_Slab *self = (scow_Slab*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_SLAB_PTR);
+
+    pthread_mutex_init(&self->lock, NULL);
+
+    self->Alloc = Slab_Alloc;
+    self->Free = Slab_Free;
+    self->Destroy = Slab_Destroy;
+
+    self->object_size = (object_size + SLAB_ALIGNMENT - 1) / SLAB_ALIGNMENT *
+            SLAB_ALIGNMENT;
+    self->objects_per_chunk = objects_per_chunk ? objects_per_chunk :
+            SLAB_OBJECTS_PER_CHUNK;
+
+    return self;
+}
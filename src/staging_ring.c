@@ -0,0 +1,333 @@
+/*
+ * @file staging_ring.c
+ * @brief Provides ring of pinned Host-side staging buffers
+ *
+ * @see staging_ring.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+
+#include "staging_ring.h"
+#include "steel_thread.h"
+
+/*! \cond PRIVATE */
+// Finds slot, which holds [host_ptr, host_ptr + size)
+static Staging_Slot* Find_Slot(scow_Staging_Ring *self, const void *host_ptr,
+        size_t size)
+{
+    const char *ptr = (const char*) host_ptr;
+
+    for (cl_uint i = 0; i < self->num_slots; i++)
+    {
+        const char *begin = (const char*) self->slots[i].host_ptr;
+
+        if (ptr >= begin && ptr < begin + self->slot_size &&
+                size <= (size_t) (begin + self->slot_size - ptr))
+        {
+            return &self->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Waits for the last transfer, which uses slot
+static ret_code Wait_Slot(Staging_Slot *slot)
+{
+    if (!slot->fence)
+    {
+        return CL_SUCCESS;
+    }
+
+    ret_code ret = clWaitForEvents(1, &slot->fence);
+
+    clReleaseEvent(slot->fence);
+    slot->fence = NULL;
+
+    return ret;
+}
+
+// Keeps event of transfer as fence of slot & gives it to caller, if asked
+static void Set_Fence(Staging_Slot *slot, cl_event evt,
+        cl_event *evt_to_generate)
+{
+    slot->fence = evt;
+
+    if (evt_to_generate)
+    {
+        clRetainEvent(evt);
+        *evt_to_generate = evt;
+    }
+}
+/*! \endcond */
+
+/**
+ * \related scow_Staging_Ring
+ *
+ * This function hands out the next slot of ring. If slot is still used by
+ * transfer, function waits for it to complete.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Staging_Ring', in
+ * which function pointer 'Acquire' is defined to point on this function.
+ *
+ * @return pointer to pinned Host memory of 'slot_size' bytes in case of
+ * success, NULL otherwise. In that case function sets error value, which is
+ * available through 'self->error'.
+ *
+ * @see cl_err_codes.h for details
+ */
+static void* Staging_Ring_Acquire(scow_Staging_Ring *self)
+{
+    OCL_CHECK_EXISTENCE(self, NULL);
+
+    Staging_Slot *slot = &self->slots[self->next_slot];
+
+    ret_code ret = Wait_Slot(slot);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS,
+            self->error->Set_Last_Code(self->error, ret), NULL);
+
+    self->next_slot = (self->next_slot + 1) % self->num_slots;
+
+    return slot->host_ptr;
+}
+
+/**
+ * \related scow_Staging_Ring
+ *
+ * This function enqueues non-blocking transfer from staging memory into
+ * buffer via Host to Device queue. Staging memory must not be changed until
+ * transfer is complete.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Staging_Ring', in
+ * which function pointer 'Upload' is defined to point on this function.
+ * @param[in] host_ptr pointer into memory, handed out by Acquire().
+ * @param[out] dest buffer to write into.
+ * @param[in] offset offset in destination buffer in bytes.
+ * @param[in] size number of bytes to transfer.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Staging_Ring_Upload(scow_Staging_Ring *self,
+        const void *host_ptr, scow_Mem_Object *dest, size_t offset,
+        size_t size, TIME_STUDY_MODE time_mode, cl_event* evt_to_generate)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(dest, INVALID_BUFFER_GIVEN);
+
+    Staging_Slot *slot = Find_Slot(self, host_ptr, size);
+    OCL_CHECK_EXISTENCE(slot, INVALID_BUFFER_GIVEN);
+
+    // Slot has single transfer in flight at a time
+    ret_code ret = Wait_Slot(slot);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    cl_event evt = NULL;
+
+    ret = dest->Write_Range(dest, CL_FALSE, offset, size, host_ptr, time_mode,
+            &evt, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    Set_Fence(slot, evt, evt_to_generate);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Staging_Ring
+ *
+ * This function enqueues non-blocking transfer from buffer into staging
+ * memory via Device to Host queue. Use Wait() or generated event before
+ * reading staging memory.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Staging_Ring', in
+ * which function pointer 'Download' is defined to point on this function.
+ * @param[out] host_ptr pointer into memory, handed out by Acquire().
+ * @param[in] src buffer to read from.
+ * @param[in] offset offset in source buffer in bytes.
+ * @param[in] size number of bytes to transfer.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed.
+ * @param[out] evt_to_generate pointer to OpenCL event that will be generated
+ * at the end of operation.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Staging_Ring_Download(scow_Staging_Ring *self, void *host_ptr,
+        scow_Mem_Object *src, size_t offset, size_t size,
+        TIME_STUDY_MODE time_mode, cl_event* evt_to_generate)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(src, INVALID_BUFFER_GIVEN);
+
+    Staging_Slot *slot = Find_Slot(self, host_ptr, size);
+    OCL_CHECK_EXISTENCE(slot, INVALID_BUFFER_GIVEN);
+
+    ret_code ret = Wait_Slot(slot);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    cl_event evt = NULL;
+
+    ret = src->Read_Range(src, CL_FALSE, offset, size, host_ptr, time_mode,
+            &evt, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    Set_Fence(slot, evt, evt_to_generate);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Staging_Ring
+ *
+ * This function waits for the last transfer, which uses slot of given memory.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Staging_Ring', in
+ * which function pointer 'Wait' is defined to point on this function.
+ * @param[in] host_ptr pointer into memory, handed out by Acquire().
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Staging_Ring_Wait(scow_Staging_Ring *self, const void *host_ptr)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    Staging_Slot *slot = Find_Slot(self, host_ptr, 0);
+    OCL_CHECK_EXISTENCE(slot, INVALID_BUFFER_GIVEN);
+
+    return Wait_Slot(slot);
+}
+
+/**
+ * \related scow_Staging_Ring
+ *
+ * This function waits for transfers in flight, unmaps & releases buffers &
+ * frees memory, allocated for ring.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Staging_Ring', in
+ * which function pointer 'Destroy' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Staging_Ring_Destroy(scow_Staging_Ring *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    if (self->slots)
+    {
+        for (cl_uint i = 0; i < self->num_slots; i++)
+        {
+            Wait_Slot(&self->slots[i]);
+
+            // Buffer is unmapped by its 'Destroy'
+            if (self->slots[i].buffer)
+            {
+                self->slots[i].buffer->Destroy(self->slots[i].buffer);
+            }
+        }
+    }
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    free(self->slots);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Staging_Ring
+ *
+ * This function allocates memory for structure, creates & maps buffer for
+ * each slot & sets function pointers.
+ *
+ * @param[in] thread pointer to Steel Thread, which gives context & queues.
+ * @param[in] num_slots number of slots in ring.
+ * @param[in] slot_size size of each slot in bytes.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_STAGING_RING_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Staging_Ring* Make_Staging_Ring(scow_Steel_Thread *thread,
+        cl_uint num_slots, size_t slot_size)
+{
+    OCL_CHECK_EXISTENCE(thread, VOID_STAGING_RING_PTR);
+
+    if (!num_slots || !slot_size)
+    {
+        return VOID_STAGING_RING_PTR;
+    }
+
+    scow_Staging_Ring *self = (scow_Staging_Ring*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_STAGING_RING_PTR);
+
+    self->Acquire = Staging_Ring_Acquire;
+    self->Upload = Staging_Ring_Upload;
+    self->Download = Staging_Ring_Download;
+    self->Wait = Staging_Ring_Wait;
+    self->Destroy = Staging_Ring_Destroy;
+
+    self->parent_thread = thread;
+    self->num_slots = num_slots;
+    self->slot_size = slot_size;
+
+    self->error = Make_Error();
+    self->slots = (Staging_Slot*) calloc(num_slots, sizeof(*self->slots));
+
+    if (!self->error || !self->slots)
+    {
+        self->Destroy(self);
+        return VOID_STAGING_RING_PTR;
+    }
+
+    for (cl_uint i = 0; i < num_slots; i++)
+    {
+        Staging_Slot *slot = &self->slots[i];
+
+        slot->buffer = Make_Buffer(thread,
+                CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, slot_size, NULL);
+        if (!slot->buffer)
+        {
+            self->Destroy(self);
+            return VOID_STAGING_RING_PTR;
+        }
+
+        // Mapping is kept until destruction, so pointer stays pinned
+        slot->host_ptr = slot->buffer->Map(slot->buffer, CL_TRUE,
+                CL_MAP_READ | CL_MAP_WRITE, DONT_MEASURE, NULL, NULL);
+        if (!slot->host_ptr)
+        {
+            self->Destroy(self);
+            return VOID_STAGING_RING_PTR;
+        }
+    }
+
+    return self;
+}
@@ -20,9 +20,15 @@
 #include <stdio.h>
 
 #include "steel_thread.h"
+#include "buffer_pool.h"
 #include "error.h"
 #include "device.h"
 #include "platform.h"
+#include "program_cache.h"
+#include "program.h"
+#include "thread_pool.h"
+#include "mem_object.h"
+#include "slab.h"
 
 static ret_code Init_OpenCL(scow_Steel_Thread* self)
 {
@@ -68,11 +74,53 @@ static ret_code Init_OpenCL(scow_Steel_Thread* self)
  * function pointer 'Destroy' is defined to point on this function
 
  * @return CL_SUCCESS always
+ *
+ * @warning all Memory Objects & kernels, made under Steel Thread, should be
+ * destroyed before. Otherwise they may be only destroyed afterwards, & Steel
+ * Thread structure is leaked for them. Programs, which weren't released, are
+ * released by this function, except ones, which still have kernels. Those are
+ * reported & leaked.
  */
 static ret_code Steel_Thread_Destroy(scow_Steel_Thread* self)
 {
     OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
 
+    // Finish asynchronous builds, which are in flight
+    if (self->build_pool)
+    {
+        self->build_pool->Destroy(self->build_pool);
+    }
+
+    /* Release programs, that are left. Each program excludes itself from the
+     * list, when released. Programs, which still have kernels, are leaked,
+     * not to be freed under them. */
+    scow_Program **p_curr = &self->programs;
+
+    while (*p_curr)
+    {
+        scow_Program *program = *p_curr;
+        cl_uint num_kernels = __atomic_load_n(&program->num_kernels,
+                __ATOMIC_RELAXED);
+
+        if (num_kernels)
+        {
+            fprintf(stderr, "Program with %u live kernels is leaked at "
+                    "destruction of Steel Thread\n", num_kernels);
+            p_curr = &program->next;
+            continue;
+        }
+
+        program->ref_count = 1;
+        program->Destroy(program);
+    }
+
+    // Free buffers belong to context, so they are released before it
+    if (self->buffer_pool)
+    {
+        self->buffer_pool->Destroy(self->buffer_pool);
+        self->buffer_pool = NULL;
+    }
+
     // Releasing OpenCL objects if any
     if (self->q_cmd)
     {
@@ -105,8 +153,41 @@ static ret_code Steel_Thread_Destroy(scow_Steel_Thread* self)
         self->device->Destroy(self->device);
     }
 
+    /* Memory Objects & kernels, which are still alive, return themselves to
+     * slabs of Steel Thread at destruction. Then slabs & Steel Thread itself
+     * are leaked, so that those objects can be destroyed later. */
+    cl_ulong num_live =
+            (self->mem_object_slab ? self->mem_object_slab->num_live : 0) +
+            (self->kernel_slab ? self->kernel_slab->num_live : 0);
+
+    if (num_live)
+    {
+        fprintf(stderr, "Steel Thread is destroyed with %lu live Memory "
+                "Objects & kernels, it's leaked\n", (unsigned long) num_live);
+
+        self->build_pool = NULL;
+        self->q_cmd = self->q_data_htod = self->q_data_dtoh =
+                self->q_data_dtod = NULL;
+        self->context = NULL;
+        self->platform = NULL;
+        self->device = NULL;
+
+        return CL_SUCCESS;
+    }
+
+    if (self->mem_object_slab)
+    {
+        self->mem_object_slab->Destroy(self->mem_object_slab);
+    }
+    if (self->kernel_slab)
+    {
+        self->kernel_slab->Destroy(self->kernel_slab);
+    }
+
     self->error->Destroy(self->error);
 
+    pthread_mutex_destroy(&self->programs_lock);
+
     free(self);
 
     return CL_SUCCESS;
@@ -183,6 +264,71 @@ static ret_code Steel_Thread_Flush_Cmd(scow_Steel_Thread* self)
     return clFlush(self->q_cmd);
 }
 
+/**
+* \related cl_Steel_Thread_t
+*
+* This function sets directory, where binaries of OpenCL programs, built with
+* READ_FROM_BINARY mode, are cached.
+*
+* @param[in,out] self pointer to structure of type 'cl_Steel_Thread_t', in which
+* function pointer 'Set_Binary_Cache_Dir' is defined to point on this function
+* @param[in] dir path to existing directory.
+*
+* @return CL_SUCCESS in case of success, error code of type 'ret_code' in
+* case of error.
+*
+* @see cl_err_codes.h for detailed error description.
+* @see 'cl_Error_t' structure for error handling.
+*/
+static ret_code Steel_Thread_Set_Binary_Cache_Dir(scow_Steel_Thread* self,
+        const char* dir)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(dir, INVALID_BUFFER_GIVEN);
+
+    if (strlen(dir) >= CL_KERNEL_FILE_NAME_SIZE)
+    {
+        return VALUE_OUT_OF_RANGE;
+    }
+
+    strcpy(self->binary_cache_dir, dir);
+
+    return CL_SUCCESS;
+}
+
+/**
+* \related cl_Steel_Thread_t
+*
+* This function makes buffers, created by Make_Buffer() without Host pointer,
+* reuse OpenCL buffers of destroyed ones. If pool is already enabled, its
+* budget is changed.
+*
+* @param[in,out] self pointer to structure of type 'cl_Steel_Thread_t', in which
+* function pointer 'Enable_Buffer_Pool' is defined to point on this function
+* @param[in] budget maximal amount of memory in bytes, kept in free buffers.
+*
+* @return CL_SUCCESS in case of success, error code of type 'ret_code' in
+* case of error.
+*
+* @see cl_err_codes.h for detailed error description.
+* @see 'scow_Buffer_Pool' structure for statistics.
+*/
+static ret_code Steel_Thread_Enable_Buffer_Pool(scow_Steel_Thread* self,
+        size_t budget)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    if (self->buffer_pool)
+    {
+        return self->buffer_pool->Set_Budget(self->buffer_pool, budget);
+    }
+
+    self->buffer_pool = Make_Buffer_Pool(self, budget);
+    OCL_CHECK_EXISTENCE(self->buffer_pool, BUFFER_NOT_ALLOCATED);
+
+    return CL_SUCCESS;
+}
+
 /**
  * \related cl_Steel_Thread_t
  *
@@ -205,11 +351,25 @@ scow_Steel_Thread* Make_Steel_Thread(cl_device_id given_device)
     scow_Steel_Thread* self = (scow_Steel_Thread*) calloc(1, sizeof(*self));
     OCL_CHECK_EXISTENCE(self, VOID_STEEL_THREAD_PTR);
 
+    pthread_mutex_init(&self->programs_lock, NULL);
+
     self->error             = Make_Error();
     self->Destroy           = Steel_Thread_Destroy;
     self->Wait_For_Commands = Steel_Thread_Wait_For_Cmd;
     self->Wait_For_Data     = Steel_Thread_Wait_For_Data;
     self->FlushCmd          = Steel_Thread_Flush_Cmd;
+    self->Set_Binary_Cache_Dir = Steel_Thread_Set_Binary_Cache_Dir;
+    self->Enable_Buffer_Pool = Steel_Thread_Enable_Buffer_Pool;
+
+    strcpy(self->binary_cache_dir, SCOW_DEFAULT_BINARY_CACHE_DIR);
+
+    self->mem_object_slab = Make_Slab(sizeof(scow_Mem_Object), 0);
+    OCL_CHECK_EXISTENCE_AND_DO(self->mem_object_slab, self->Destroy(self),
+        VOID_STEEL_THREAD_PTR);
+
+    self->kernel_slab = Make_Slab(sizeof(scow_Kernel), 0);
+    OCL_CHECK_EXISTENCE_AND_DO(self->kernel_slab, self->Destroy(self),
+        VOID_STEEL_THREAD_PTR);
 
     // Get OpenCL Platform, to which OpenCL Device belongs to;
     cl_platform_id platform;
@@ -222,6 +382,10 @@ scow_Steel_Thread* Make_Steel_Thread(cl_device_id given_device)
     OCL_CHECK_EXISTENCE_AND_DO(self->device, self->Destroy(self),
         VOID_STEEL_THREAD_PTR);
 
+    // Copying between Host & Device makes no sense, if memory is the same
+    self->zero_copy = (self->device->device_type & CL_DEVICE_TYPE_CPU) ||
+            self->device->host_unified_memory;
+
     self->platform = Make_Platform(platform);
     OCL_CHECK_EXISTENCE_AND_DO(self->platform, self->Destroy(self),
         VOID_STEEL_THREAD_PTR);
@@ -0,0 +1,310 @@
+/*
+ * @file stream_pipeline.c
+ * @brief Provides streaming of data through kernel with overlapped transfers
+ *
+ * @see stream_pipeline.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdlib.h>
+
+#include "stream_pipeline.h"
+#include "steel_thread.h"
+
+/*! \cond PRIVATE */
+// Waits for download of chunk in slot & passes it to sink, if any
+static ret_code Drain_Slot(Stream_Slot *slot, Stream_Sink sink,
+        void *user_data)
+{
+    if (!slot->read_done)
+    {
+        return CL_SUCCESS;
+    }
+
+    ret_code ret = clWaitForEvents(1, &slot->read_done);
+
+    clReleaseEvent(slot->read_done);
+    slot->read_done = NULL;
+
+    if (ret == CL_SUCCESS && sink)
+    {
+        ret = sink(user_data, slot->chunk_index, slot->host_output,
+                slot->output_size);
+    }
+
+    return ret;
+}
+
+// Enqueues upload, processing & download of chunk, chained by events
+static ret_code Enqueue_Chunk(scow_Stream_Pipeline *self, Stream_Slot *slot,
+        cl_uint chunk_index, size_t size, Stream_Prepare prepare,
+        void *user_data)
+{
+    scow_Steel_Thread *thread = self->parent_thread;
+    scow_Kernel *kernel = self->kernel;
+    cl_event write_done = NULL, compute_done = NULL;
+
+    ret_code ret = clEnqueueWriteBuffer(thread->q_data_htod,
+            slot->input->cl_mem_object, CL_FALSE, 0, size, slot->host_input,
+            0, NULL, &write_done);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    kernel->Bind_Arg(kernel, 0, sizeof(cl_mem), &slot->input->cl_mem_object);
+    kernel->Bind_Arg(kernel, 1, sizeof(cl_mem), &slot->output->cl_mem_object);
+
+    if (prepare)
+    {
+        ret = prepare(user_data, kernel, chunk_index, size);
+    }
+
+    if (ret == CL_SUCCESS)
+    {
+        ret = kernel->Launch_Bound(kernel, &thread->q_cmd, 1, &write_done,
+                &compute_done, DONT_MEASURE);
+    }
+
+    clReleaseEvent(write_done);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    // Output of partial chunk is proportional to its input
+    slot->output_size = (size == self->input_chunk_size) ?
+            self->output_chunk_size :
+            (size_t) ((double) self->output_chunk_size * size /
+                    self->input_chunk_size);
+    slot->chunk_index = chunk_index;
+
+    if (slot->output_size)
+    {
+        ret = clEnqueueReadBuffer(thread->q_data_dtoh,
+                slot->output->cl_mem_object, CL_FALSE, 0, slot->output_size,
+                slot->host_output, 1, &compute_done, &slot->read_done);
+        clReleaseEvent(compute_done);
+    }
+    else
+    {
+        slot->read_done = compute_done;
+    }
+
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+    // Each stage is started at once, not to wait for the next one
+    clFlush(thread->q_data_htod);
+    clFlush(thread->q_cmd);
+    clFlush(thread->q_data_dtoh);
+
+    return CL_SUCCESS;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Stream_Pipeline
+ *
+ * This function streams whole input through kernel. Source is called for the
+ * next chunk, while previous ones are in flight, & sink is called for each
+ * chunk, as soon as its slot is needed for new chunk or input is over.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Stream_Pipeline', in
+ * which function pointer 'Run' is defined to point on this function.
+ * @param[in] source callback, which fills input chunks.
+ * @param[in] prepare callback, which prepares kernel for chunk. If NULL,
+ * ND sizes & arguments, which are set to kernel, are used for every chunk.
+ * @param[in] sink callback, which consumes output chunks.
+ * @param[in] user_data pointer, which is passed to callbacks.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ * In case of error no more chunks are enqueued, chunks in flight are waited
+ * for, but not passed to sink.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Stream_Pipeline_Run(scow_Stream_Pipeline *self,
+        Stream_Source source, Stream_Prepare prepare, Stream_Sink sink,
+        void *user_data)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(source, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(sink, INVALID_BUFFER_GIVEN);
+
+    ret_code ret = CL_SUCCESS;
+    cl_uint chunk = 0;
+
+    for (;; chunk++)
+    {
+        Stream_Slot *slot = &self->slots[chunk % self->depth];
+
+        // Slot is reused by chunk, which is 'depth' chunks later
+        ret = Drain_Slot(slot, sink, user_data);
+        if (ret != CL_SUCCESS)
+        {
+            break;
+        }
+
+        size_t size = source(user_data, chunk, slot->host_input,
+                self->input_chunk_size);
+        if (!size)
+        {
+            break;
+        }
+
+        if (size > self->input_chunk_size)
+        {
+            ret = INVALID_BUFFER_SIZE;
+            break;
+        }
+
+        ret = Enqueue_Chunk(self, slot, chunk, size, prepare, user_data);
+        if (ret != CL_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    // The oldest chunk in flight follows the current slot
+    for (cl_uint i = 1; i <= self->depth; i++)
+    {
+        Stream_Slot *slot = &self->slots[(chunk + i) % self->depth];
+        ret_code drain_ret = Drain_Slot(slot, ret == CL_SUCCESS ? sink : NULL,
+                user_data);
+
+        if (ret == CL_SUCCESS)
+        {
+            ret = drain_ret;
+        }
+    }
+
+    self->num_chunks = chunk;
+    self->error->Set_Last_Code(self->error, ret);
+
+    return ret;
+}
+
+/**
+ * \related scow_Stream_Pipeline
+ *
+ * This function waits for chunks in flight, releases buffers & frees memory,
+ * allocated for pipeline.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Stream_Pipeline', in
+ * which function pointer 'Destroy' is defined to point on this function.
+ *
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ *
+ * @see cl_err_codes.h for details
+ */
+static ret_code Stream_Pipeline_Destroy(scow_Stream_Pipeline *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    if (self->slots)
+    {
+        for (cl_uint i = 0; i < self->depth; i++)
+        {
+            Stream_Slot *slot = &self->slots[i];
+
+            Drain_Slot(slot, NULL, NULL);
+
+            if (slot->input)
+            {
+                slot->input->Destroy(slot->input);
+            }
+            if (slot->output)
+            {
+                slot->output->Destroy(slot->output);
+            }
+
+            free(slot->host_input);
+            free(slot->host_output);
+        }
+    }
+
+    if (self->error)
+    {
+        self->error->Destroy(self->error);
+    }
+
+    free(self->slots);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Stream_Pipeline
+ *
+ * This function allocates memory for structure, Device & Host buffers for
+ * each chunk in flight & sets function pointers.
+ *
+ * @param[in] kernel kernel, which processes chunks. It must outlive pipeline.
+ * @param[in] depth maximal number of chunks in flight. 3 is enough to overlap
+ * all stages.
+ * @param[in] input_chunk_size size of full input chunk in bytes.
+ * @param[in] output_chunk_size size of full output chunk in bytes.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_STREAM_PIPELINE_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function.
+ */
+scow_Stream_Pipeline* Make_Stream_Pipeline(scow_Kernel *kernel, cl_uint depth,
+        size_t input_chunk_size, size_t output_chunk_size)
+{
+    OCL_CHECK_EXISTENCE(kernel, VOID_STREAM_PIPELINE_PTR);
+
+    if (!depth || !input_chunk_size || !output_chunk_size)
+    {
+        return VOID_STREAM_PIPELINE_PTR;
+    }
+
+    scow_Stream_Pipeline *self = (scow_Stream_Pipeline*) calloc(1,
+            sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_STREAM_PIPELINE_PTR);
+
+    self->Run = Stream_Pipeline_Run;
+    self->Destroy = Stream_Pipeline_Destroy;
+
+    self->parent_thread = kernel->parent_steel_thread;
+    self->kernel = kernel;
+    self->depth = depth;
+    self->input_chunk_size = input_chunk_size;
+    self->output_chunk_size = output_chunk_size;
+
+    self->error = Make_Error();
+    self->slots = (Stream_Slot*) calloc(depth, sizeof(*self->slots));
+
+    if (!self->error || !self->slots)
+    {
+        self->Destroy(self);
+        return VOID_STREAM_PIPELINE_PTR;
+    }
+
+    for (cl_uint i = 0; i < depth; i++)
+    {
+        Stream_Slot *slot = &self->slots[i];
+
+        slot->input = Make_Buffer(self->parent_thread, CL_MEM_READ_ONLY,
+                input_chunk_size, NULL);
+        slot->output = Make_Buffer(self->parent_thread, CL_MEM_WRITE_ONLY,
+                output_chunk_size, NULL);
+        slot->host_input = malloc(input_chunk_size);
+        slot->host_output = malloc(output_chunk_size);
+
+        if (!slot->input || !slot->output || !slot->host_input ||
+                !slot->host_output)
+        {
+            self->Destroy(self);
+            return VOID_STREAM_PIPELINE_PTR;
+        }
+    }
+
+    return self;
+}
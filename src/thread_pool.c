@@ -0,0 +1,199 @@
+/*
+ * @file thread_pool.c
+ * @brief Provides simple pool of Host worker threads
+ *
+ * @see thread_pool.h
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "thread_pool.h"
+
+/*! \cond PRIVATE */
+static void* Thread_Pool_Worker(void *arg)
+{
+    scow_Thread_Pool *self = (scow_Thread_Pool*) arg;
+
+    pthread_mutex_lock(&self->lock);
+
+    for (;;)
+    {
+        while (!self->head && !self->shutdown)
+        {
+            pthread_cond_wait(&self->has_tasks, &self->lock);
+        }
+
+        // Shutdown is honored only when all submitted jobs are done
+        if (!self->head)
+        {
+            break;
+        }
+
+        Thread_Pool_Task *task = self->head;
+        self->head = task->next;
+        if (!self->head)
+        {
+            self->tail = NULL;
+        }
+
+        pthread_mutex_unlock(&self->lock);
+
+        task->job(task->job_arg);
+        free(task);
+
+        pthread_mutex_lock(&self->lock);
+    }
+
+    pthread_mutex_unlock(&self->lock);
+
+    return NULL;
+}
+/*! \endcond */
+
+/**
+ * \related scow_Thread_Pool
+ *
+ * This function waits for all submitted jobs to finish, stops worker threads
+ * & frees allocated memory.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Thread_Pool', in which
+ * function pointer 'Destroy' is defined to point on this function
+
+ * @return CL_SUCCESS always
+ */
+static ret_code Thread_Pool_Destroy(scow_Thread_Pool *self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    pthread_mutex_lock(&self->lock);
+    self->shutdown = CL_TRUE;
+    pthread_cond_broadcast(&self->has_tasks);
+    pthread_mutex_unlock(&self->lock);
+
+    for (size_t i = 0; i < self->num_workers; i++)
+    {
+        pthread_join(self->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&self->has_tasks);
+    pthread_mutex_destroy(&self->lock);
+
+    free(self->workers);
+    free(self);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Thread_Pool
+ *
+ * This function submits job for execution by one of the workers.
+ *
+ * @param[in,out] self pointer to structure of type 'scow_Thread_Pool', in which
+ * function pointer 'Submit' is defined to point on this function
+ * @param[in] job function to be executed.
+ * @param[in] job_arg argument, that will be passed to job.
+
+ * @return CL_SUCCESS in case of success, error code of type ret_code otherwise.
+ */
+static ret_code Thread_Pool_Submit(scow_Thread_Pool *self, Thread_Pool_Job job,
+        void *job_arg)
+{
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+    OCL_CHECK_EXISTENCE(job, PROVIDING_UNDEF_PTR);
+
+    Thread_Pool_Task *task = (Thread_Pool_Task*) calloc(1, sizeof(*task));
+    OCL_CHECK_EXISTENCE(task, BUFFER_NOT_ALLOCATED);
+
+    task->job = job;
+    task->job_arg = job_arg;
+
+    pthread_mutex_lock(&self->lock);
+
+    if (self->tail)
+    {
+        self->tail->next = task;
+    }
+    else
+    {
+        self->head = task;
+    }
+    self->tail = task;
+
+    pthread_cond_signal(&self->has_tasks);
+    pthread_mutex_unlock(&self->lock);
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related scow_Thread_Pool
+ *
+ * This function allocates memory for structure, sets function pointers &
+ * starts worker threads.
+ *
+ * @param[in] num_workers number of worker threads. Pass 0 to start one worker
+ * per online Host CPU core.
+ *
+ * @return pointer to allocated structure in case of success,
+ * \ref VOID_THREAD_POOL_PTR otherwise
+ *
+ * @warning always use 'Destroy' function pointer to free memory, allocated by
+ * this function. It finishes all submitted jobs before return.
+ */
+scow_Thread_Pool* Make_Thread_Pool(size_t num_workers)
+{
+    if (num_workers == 0)
+    {
+        long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_workers = (num_cores > 0) ? (size_t) num_cores : 1;
+    }
+
+    scow_Thread_Pool *self = (scow_Thread_Pool*) calloc(1, sizeof(*self));
+    OCL_CHECK_EXISTENCE(self, VOID_THREAD_POOL_PTR);
+
+    self->workers = (pthread_t*) calloc(num_workers, sizeof(*self->workers));
+    if (!self->workers)
+    {
+        free(self);
+        return VOID_THREAD_POOL_PTR;
+    }
+
+    self->Submit = Thread_Pool_Submit;
+    self->Destroy = Thread_Pool_Destroy;
+
+    pthread_mutex_init(&self->lock, NULL);
+    pthread_cond_init(&self->has_tasks, NULL);
+
+    // Start as many workers as we can, but at least one is required
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        if (pthread_create(&self->workers[i], NULL, Thread_Pool_Worker, self))
+        {
+            break;
+        }
+
+        self->num_workers++;
+    }
+
+    if (self->num_workers == 0)
+    {
+        self->Destroy(self);
+        return VOID_THREAD_POOL_PTR;
+    }
+
+    return self;
+}
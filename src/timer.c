@@ -19,6 +19,95 @@
 #include "kernel.h"
 #include <stdlib.h>
 
+/*! \cond PRIVATE */
+static cl_double Get_Profiled_Time_uS(cl_event event)
+{
+    cl_ulong start = 0, end = 0;
+    cl_int ret;
+
+    ret = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+            sizeof(cl_ulong), &start, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, -1.0);
+
+    ret = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+            sizeof(cl_ulong), &end, NULL);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, -1.0);
+
+    return (cl_double) (end - start) * (cl_double) (1e-03);
+}
+
+// Must be called under lock
+static void Fold_Device_Time(scow_Timer* self, cl_double run_time)
+{
+    /* Increment num_calls only for measured operations to have average runtime,
+     * which is always consistent. */
+    self->current_time_device = run_time;
+    self->total_time_device += run_time;
+    self->num_calls_device++;
+}
+
+// Called from OpenCL runtime thread, when operation is complete
+static void CL_CALLBACK Timer_Event_Callback(cl_event event,
+        cl_int event_command_exec_status, void* user_data)
+{
+    scow_Timer* self = (scow_Timer*) user_data;
+
+    // Abnormally terminated command has no valid time
+    cl_double run_time = (event_command_exec_status == CL_COMPLETE) ?
+            Get_Profiled_Time_uS(event) : -1.0;
+
+    clReleaseEvent(event);
+
+    pthread_mutex_lock(&self->lock);
+
+    if (run_time >= 0.0)
+    {
+        Fold_Device_Time(self, run_time);
+    }
+
+    self->num_pending--;
+    pthread_cond_broadcast(&self->pending_done);
+
+    // Timer may be destroyed right after that, so it must be the last access
+    pthread_mutex_unlock(&self->lock);
+}
+/*! \endcond */
+
+cl_double Gather_Time_uS(cl_event* event)
+{
+    OCL_CHECK_EXISTENCE(event, -1.0);
+
+    cl_int ret = clWaitForEvents(1, event);
+    OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, -1.0);
+
+    return Get_Profiled_Time_uS(*event);
+}
+
+/**
+ * \related cl_Timer_t
+ *
+ * This function waits for pending measurements & releases synchronization
+ * objects. Memory of structure, initialized by Init_Timer(), is freed together
+ * with structure, which it's embedded into.
+ *
+ * @param[in,out] self pointer to structure 'self' of type 'cl_Timer_t',
+ * in which fptr 'Destroy' is defined to point on this function
+ *
+ * @return CL_SUCCESS always
+ */
+static ret_code Timer_Release(scow_Timer* self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    // Runtime callbacks refer Timer until they are done
+    self->Wait_Pending(self);
+
+    pthread_cond_destroy(&self->pending_done);
+    pthread_mutex_destroy(&self->lock);
+
+    return CL_SUCCESS;
+}
+
 /**
  * \related cl_Timer_t
  *
@@ -33,6 +122,7 @@ static ret_code Timer_Destroy(scow_Timer* self)
 {
     OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
 
+    Timer_Release(self);
     free(self);
 
     return CL_SUCCESS;
@@ -124,10 +214,12 @@ static ret_code Timer_Reset(scow_Timer* self, TIME_SIDE what_time)
         break;
 
     case DEVICE_TIME:
+        pthread_mutex_lock(&self->lock);
         self->current_time_device = 0.0;
         self->dirty_bit_dev = CL_FALSE;
         self->num_calls_device = 0;
         self->total_time_device = 0;
+        pthread_mutex_unlock(&self->lock);
         break;
 
     default:
@@ -167,8 +259,9 @@ static double Timer_Get_Total_Time(scow_Timer* self, TIME_SIDE what_time)
         break;
 
     case DEVICE_TIME:
-
-        return self->total_time_device;
+        pthread_mutex_lock(&self->lock);
+        exec_time = self->total_time_device;
+        pthread_mutex_unlock(&self->lock);
         break;
 
     default:
@@ -206,7 +299,9 @@ static double Timer_Get_Last_Time(scow_Timer* self, TIME_SIDE what_time)
         break;
 
     case DEVICE_TIME:
-        return self->current_time_device;
+        pthread_mutex_lock(&self->lock);
+        exec_time = self->current_time_device;
+        pthread_mutex_unlock(&self->lock);
         break;
 
     default:
@@ -235,7 +330,8 @@ static double Timer_Get_Last_Time(scow_Timer* self, TIME_SIDE what_time)
 static long unsigned int Timer_Get_Num_Calls(scow_Timer* self,
         TIME_SIDE what_time)
 {
-    OCL_CHECK_EXISTENCE(self, ZERO_TIMES);
+    long unsigned int num_calls = ZERO_TIMES;
+    OCL_CHECK_EXISTENCE(self, num_calls);
 
     switch (what_time)
     {
@@ -245,8 +341,9 @@ static long unsigned int Timer_Get_Num_Calls(scow_Timer* self,
         break;
 
     case DEVICE_TIME:
-
-        return self->num_calls_device;
+        pthread_mutex_lock(&self->lock);
+        num_calls = self->num_calls_device;
+        pthread_mutex_unlock(&self->lock);
         break;
 
     default:
@@ -254,7 +351,122 @@ static long unsigned int Timer_Get_Num_Calls(scow_Timer* self,
         break;
     }
 
-    return ZERO_TIMES;
+    return num_calls;
+}
+
+/**
+ * \related cl_Timer_t
+ *
+ * This function gathers execution time of command, associated with OpenCL
+ * event, & folds it into Device counters.
+ *
+ * @param[in,out] self pointer to structure 'self' of type 'cl_Timer_t', in
+ * which fptr 'Measure_Event' is defined to point on this function
+ * @param[in] event pointer to OpenCL event of command, enqueued into queue with
+ * profiling enabled. Event may be released right after call.
+ * @param[in] time_mode enumeration, that denotes how time measurement should be
+ * performed. In \ref MEASURE mode function waits for command to complete, in
+ * \ref MEASURE_ASYNC mode it returns immediately & time is folded, when command
+ * is complete.
+ *
+ * @return CL_SUCCESS in case of success, error code of type 'ret_code' otherwise
+ *
+ * @see cl_err_codes.h for details about error codes.
+ * @see 'cl_Error_t' for details about error handling.
+ */
+static ret_code Timer_Measure_Event(scow_Timer* self, cl_event* event,
+        TIME_STUDY_MODE time_mode)
+{
+    cl_double run_time;
+    cl_command_queue queue = NULL;
+    cl_int ret;
+
+    OCL_CHECK_EXISTENCE(self, INVALID_BUFFER_GIVEN);
+
+    switch (time_mode)
+    {
+    case MEASURE:
+        OCL_CHECK_EXISTENCE(event, INVALID_EVENT);
+
+        run_time = Gather_Time_uS(event);
+
+        if (run_time < 0.0)
+        {
+            return INVALID_EVENT;
+        }
+
+        pthread_mutex_lock(&self->lock);
+        Fold_Device_Time(self, run_time);
+        pthread_mutex_unlock(&self->lock);
+        break;
+
+    case MEASURE_ASYNC:
+        OCL_CHECK_EXISTENCE(event, INVALID_EVENT);
+
+        // Callback owns its own reference to event
+        ret = clRetainEvent(*event);
+        OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+
+        pthread_mutex_lock(&self->lock);
+        self->num_pending++;
+        pthread_mutex_unlock(&self->lock);
+
+        ret = clSetEventCallback(*event, CL_COMPLETE, Timer_Event_Callback,
+                self);
+
+        if (ret != CL_SUCCESS)
+        {
+            clReleaseEvent(*event);
+
+            pthread_mutex_lock(&self->lock);
+            self->num_pending--;
+            pthread_mutex_unlock(&self->lock);
+
+            OCL_DIE_ON_ERROR(ret, CL_SUCCESS, NULL, ret);
+        }
+
+        /* Command must be submitted, otherwise callback may never be called
+         * & Wait_Pending() hangs. User events have no queue. */
+        ret = clGetEventInfo(*event, CL_EVENT_COMMAND_QUEUE, sizeof(queue),
+                &queue, NULL);
+        if (ret == CL_SUCCESS && queue)
+        {
+            clFlush(queue);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return CL_SUCCESS;
+}
+
+/**
+ * \related cl_Timer_t
+ *
+ * This function waits until all operations, measured in \ref MEASURE_ASYNC
+ * mode, are complete & their time is folded into Timer.
+ *
+ * @param[in,out] self pointer to structure 'self' of type 'cl_Timer_t', in
+ * which fptr 'Wait_Pending' is defined to point on this function
+ *
+ * @return CL_SUCCESS always
+ */
+static ret_code Timer_Wait_Pending(scow_Timer* self)
+{
+    OCL_CHECK_EXISTENCE(self, CL_SUCCESS);
+
+    pthread_mutex_lock(&self->lock);
+
+    while (self->num_pending > 0)
+    {
+        pthread_cond_wait(&self->pending_done, &self->lock);
+    }
+
+    pthread_mutex_unlock(&self->lock);
+
+    return CL_SUCCESS;
 }
 
 /**
@@ -278,15 +490,46 @@ scow_Timer* Make_Timer(scow_Kernel* parent_kernel)
     scow_Timer* self = (scow_Timer*) calloc(1, sizeof(*self));
     OCL_CHECK_EXISTENCE(self, VOID_TIME_STUDY_PTR);
 
+    Init_Timer(self, parent_kernel);
     self->Destroy = Timer_Destroy;
+
+    return self;
+}
+
+/**
+ * \related cl_Timer_t
+ *
+ * This function initializes Timer, which is embedded into another structure,
+ * & sets function pointers.
+ *
+ * @param[out] self pointer to zero-filled structure to initialize.
+ * @param[in] parent_kernel pointer to Minimal Kernel. This argument is
+ * optional - if you don't need to measure kernel time, provide void pointer as
+ * argument.
+ *
+ * @return pointer to initialized structure in case of success,
+ * \ref VOID_TIME_STUDY_PTR otherwise
+ *
+ * @warning 'Destroy' function pointer doesn't free memory of structure.
+ */
+scow_Timer* Init_Timer(scow_Timer* self, scow_Kernel* parent_kernel)
+{
+    OCL_CHECK_EXISTENCE(self, VOID_TIME_STUDY_PTR);
+
+    self->Destroy = Timer_Release;
     self->Start = Timer_Start;
     self->Stop = Timer_Stop;
     self->Reset = Timer_Reset;
     self->Get_Total_Time = Timer_Get_Total_Time;
     self->Get_Last_Time = Timer_Get_Last_Time;
     self->Get_Num_Calls = Timer_Get_Num_Calls;
+    self->Measure_Event = Timer_Measure_Event;
+    self->Wait_Pending = Timer_Wait_Pending;
 
     self->parent_kernel = parent_kernel;
 
+    pthread_mutex_init(&self->lock, NULL);
+    pthread_cond_init(&self->pending_done, NULL);
+
     return self;
 }
@@ -0,0 +1,149 @@
+/*
+ * @file test_arena.c
+ * @brief Tests coalescing of free ranges in arena
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <string.h>
+
+#include "../src/arena.c"
+#include "test_check.h"
+
+/*! \cond PRIVATE */
+// Arena over fake buffer, ranges are taken & given without OpenCL
+static void Init_Test_Arena(scow_Arena *arena, scow_Mem_Object *buffer,
+        size_t size)
+{
+    memset(arena, 0, sizeof(*arena));
+    memset(buffer, 0, sizeof(*buffer));
+
+    buffer->size = size;
+    arena->buffer = buffer;
+    arena->alignment = 1;
+}
+
+static cl_uint Count_Blocks(scow_Arena *arena)
+{
+    cl_uint num_blocks = 0;
+
+    for (Arena_Block *block = arena->free_blocks; block; block = block->next)
+    {
+        num_blocks++;
+    }
+
+    return num_blocks;
+}
+
+static int Has_Block(scow_Arena *arena, cl_uint index, size_t origin,
+        size_t size)
+{
+    Arena_Block *block = arena->free_blocks;
+
+    for (cl_uint i = 0; block && i < index; i++)
+    {
+        block = block->next;
+    }
+
+    return block && block->origin == origin && block->size == size;
+}
+
+static int Take_Ranges(scow_Arena *arena, cl_uint num_ranges, size_t size)
+{
+    for (cl_uint i = 0; i < num_ranges; i++)
+    {
+        size_t origin = 0;
+
+        CHECK(Take_Range(arena, size, &origin));
+        CHECK(origin == i * size);
+    }
+
+    return 0;
+}
+/*! \endcond */
+
+// Ranges, freed below top, are merged with neighbours & top shrinks over them
+static int Test_Free_Mixed_Order()
+{
+    scow_Arena arena;
+    scow_Mem_Object buffer;
+
+    Init_Test_Arena(&arena, &buffer, 1024);
+
+    CHECK(!Take_Ranges(&arena, 4, 100));
+    CHECK(arena.top == 400);
+
+    CHECK(Give_Range(&arena, 100, 100) == CL_SUCCESS);
+    CHECK(arena.top == 400);
+    CHECK(Count_Blocks(&arena) == 1 && Has_Block(&arena, 0, 100, 100));
+
+    // Top range doesn't touch free block, so block stays
+    CHECK(Give_Range(&arena, 300, 100) == CL_SUCCESS);
+    CHECK(arena.top == 300);
+    CHECK(Count_Blocks(&arena) == 1 && Has_Block(&arena, 0, 100, 100));
+
+    // Range is merged with the next block
+    CHECK(Give_Range(&arena, 0, 100) == CL_SUCCESS);
+    CHECK(Count_Blocks(&arena) == 1 && Has_Block(&arena, 0, 0, 200));
+
+    // Top shrinks over the last block
+    CHECK(Give_Range(&arena, 200, 100) == CL_SUCCESS);
+    CHECK(arena.top == 0);
+    CHECK(Count_Blocks(&arena) == 0);
+
+    return 0;
+}
+
+// Range, which closes gap between two blocks, merges them into one
+static int Test_Close_Gap()
+{
+    scow_Arena arena;
+    scow_Mem_Object buffer;
+    size_t origin = 0;
+
+    Init_Test_Arena(&arena, &buffer, 1024);
+
+    CHECK(!Take_Ranges(&arena, 4, 100));
+
+    CHECK(Give_Range(&arena, 200, 100) == CL_SUCCESS);
+    CHECK(Give_Range(&arena, 0, 100) == CL_SUCCESS);
+    CHECK(Count_Blocks(&arena) == 2);
+    CHECK(Has_Block(&arena, 0, 0, 100) && Has_Block(&arena, 1, 200, 100));
+
+    CHECK(Give_Range(&arena, 100, 100) == CL_SUCCESS);
+    CHECK(Count_Blocks(&arena) == 1 && Has_Block(&arena, 0, 0, 300));
+    CHECK(arena.top == 400);
+
+    // Free block is reused by first fit before top
+    CHECK(Take_Range(&arena, 50, &origin));
+    CHECK(origin == 0);
+    CHECK(Count_Blocks(&arena) == 1 && Has_Block(&arena, 0, 50, 250));
+
+    CHECK(Take_Range(&arena, 250, &origin));
+    CHECK(origin == 50);
+    CHECK(Count_Blocks(&arena) == 0);
+
+    // Range, which doesn't fit into the rest of arena, isn't given
+    CHECK(!Take_Range(&arena, 1024 - 400 + 1, &origin));
+    CHECK(arena.top == 400);
+
+    return 0;
+}
+
+int main()
+{
+    int num_failed = 0;
+
+    num_failed += Test_Free_Mixed_Order();
+    num_failed += Test_Close_Gap();
+
+    return num_failed ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * @file test_buffer_pool.c
+ * @brief Tests size classes, trimming & statistics of Buffer Pool
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../src/buffer_pool.c"
+#include "test_check.h"
+
+/*! \cond PRIVATE */
+/* Pool without parent Steel Thread. Free lists are built by hand, so no
+ * OpenCL buffer is made. */
+static void Init_Test_Pool(scow_Buffer_Pool *pool, size_t budget)
+{
+    memset(pool, 0, sizeof(*pool));
+    pthread_mutex_init(&pool->lock, NULL);
+
+    pool->stats.budget = budget;
+}
+
+static void Release_Test_Pool(scow_Buffer_Pool *pool)
+{
+    for (cl_uint i = 0; i < BUFFER_POOL_NUM_CLASSES; i++)
+    {
+        while (pool->free_lists[i])
+        {
+            Buffer_Pool_Entry *entry = pool->free_lists[i];
+
+            pool->free_lists[i] = entry->next;
+            free(entry);
+        }
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+}
+
+// Entries without fences are free at once
+static int Push_Entry(scow_Buffer_Pool *pool, cl_uint size_class,
+        cl_mem_flags mem_flags, cl_mem mem)
+{
+    Buffer_Pool_Entry *entry = (Buffer_Pool_Entry*) calloc(1, sizeof(*entry));
+    CHECK(entry);
+
+    entry->mem = mem;
+    entry->mem_flags = mem_flags;
+    entry->next = pool->free_lists[size_class];
+
+    pool->free_lists[size_class] = entry;
+    pool->stats.cached_bytes += (size_t) 1 << size_class;
+
+    return 0;
+}
+/*! \endcond */
+
+// Sizes up to the smallest class take it
+static int Test_Small_Sizes()
+{
+    size_t min_size = (size_t) 1 << BUFFER_POOL_MIN_CLASS_LOG2;
+
+    CHECK(Get_Size_Class(0) == BUFFER_POOL_MIN_CLASS_LOG2);
+    CHECK(Get_Size_Class(1) == BUFFER_POOL_MIN_CLASS_LOG2);
+    CHECK(Get_Size_Class(min_size) == BUFFER_POOL_MIN_CLASS_LOG2);
+
+    return 0;
+}
+
+// Size takes the smallest power of two class, which fits it
+static int Test_Class_Bounds()
+{
+    for (cl_uint i = BUFFER_POOL_MIN_CLASS_LOG2;
+            i < BUFFER_POOL_NUM_CLASSES - 1; i++)
+    {
+        size_t class_size = (size_t) 1 << i;
+
+        CHECK(Get_Size_Class(class_size) == i);
+        CHECK(Get_Size_Class(class_size + 1) == i + 1);
+        CHECK(Get_Size_Class(class_size - 1) == i);
+    }
+
+    // The largest class takes everything
+    CHECK(Get_Size_Class(SIZE_MAX) == BUFFER_POOL_NUM_CLASSES - 1);
+
+    return 0;
+}
+
+/* Buffers of the largest classes are released first, until pool fits into
+ * limit. Released buffers have no OpenCL object, which runtime rejects. */
+static int Test_Trim_Largest_First()
+{
+    scow_Buffer_Pool pool;
+
+    Init_Test_Pool(&pool, 1 << 20);
+
+    CHECK(!Push_Entry(&pool, 8, CL_MEM_READ_WRITE, NULL));
+    CHECK(!Push_Entry(&pool, 10, CL_MEM_READ_WRITE, NULL));
+    CHECK(!Push_Entry(&pool, 12, CL_MEM_READ_WRITE, NULL));
+    CHECK(!Push_Entry(&pool, 12, CL_MEM_READ_ONLY, NULL));
+    CHECK(pool.stats.cached_bytes == 256 + 1024 + 2 * 4096);
+
+    Trim_Locked(&pool, 4096 + 1024 + 256);
+    CHECK(pool.stats.cached_bytes == 4096 + 1024 + 256);
+    CHECK(pool.stats.num_trimmed == 1);
+    CHECK(pool.free_lists[12] && !pool.free_lists[12]->next);
+
+    Trim_Locked(&pool, 2000);
+    CHECK(pool.stats.cached_bytes == 1024 + 256);
+    CHECK(pool.stats.num_trimmed == 2);
+    CHECK(!pool.free_lists[12] && pool.free_lists[10] && pool.free_lists[8]);
+
+    // Budget is enforced at once
+    CHECK(Buffer_Pool_Set_Budget(&pool, 256) == CL_SUCCESS);
+    CHECK(pool.stats.budget == 256 && pool.stats.cached_bytes == 256);
+    CHECK(pool.stats.num_trimmed == 3);
+    CHECK(!pool.free_lists[10] && pool.free_lists[8]);
+
+    CHECK(Buffer_Pool_Set_Budget(&pool, 0) == CL_SUCCESS);
+    CHECK(pool.stats.cached_bytes == 0 && pool.stats.num_trimmed == 4);
+    CHECK(!pool.free_lists[8]);
+
+    Release_Test_Pool(&pool);
+
+    return 0;
+}
+
+// Free buffer is taken only with the same flags & size class
+static int Test_Hits_And_Misses()
+{
+    scow_Buffer_Pool pool;
+    scow_Buffer_Pool_Stats stats;
+    cl_mem fake_mem = (cl_mem) &pool;
+
+    Init_Test_Pool(&pool, 1 << 20);
+
+    CHECK(!Push_Entry(&pool, 10, CL_MEM_READ_WRITE, fake_mem));
+
+    CHECK(Buffer_Pool_Take(&pool, CL_MEM_READ_ONLY, 1000) == NULL);
+    CHECK(Buffer_Pool_Take(&pool, CL_MEM_READ_WRITE, 2000) == NULL);
+    CHECK(pool.stats.num_misses == 2 && pool.stats.num_hits == 0);
+    CHECK(pool.stats.cached_bytes == 1024);
+
+    // Memory, which refers Host pointer, is never pooled & isn't counted
+    CHECK(Buffer_Pool_Take(&pool, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR,
+            1000) == NULL);
+    CHECK(pool.stats.num_misses == 2);
+
+    CHECK(Buffer_Pool_Take(&pool, CL_MEM_READ_WRITE, 1000) == fake_mem);
+    CHECK(pool.stats.num_hits == 1 && pool.stats.cached_bytes == 0);
+    CHECK(!pool.free_lists[10]);
+
+    CHECK(Buffer_Pool_Get_Stats(&pool, &stats) == CL_SUCCESS);
+    CHECK(stats.num_hits == 1 && stats.num_misses == 2);
+    CHECK(stats.cached_bytes == 0 && stats.budget == 1 << 20);
+
+    Release_Test_Pool(&pool);
+
+    return 0;
+}
+
+int main()
+{
+    int num_failed = 0;
+
+    num_failed += Test_Small_Sizes();
+    num_failed += Test_Class_Bounds();
+    num_failed += Test_Trim_Largest_First();
+    num_failed += Test_Hits_And_Misses();
+
+    return num_failed ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * @file test_check.h
+ * @brief Provides checks for host-only unit tests
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#ifndef SCOW_TEST_CHECK_H_
+#define SCOW_TEST_CHECK_H_
+
+#include <stdio.h>
+
+/*! \def CHECK
+ * Reports failed condition & makes test function, which contains it, fail
+ */
+#undef CHECK
+#define CHECK(cond)\
+do {\
+    if (!(cond))\
+    {\
+        fprintf(stderr, "%s:%d: check '%s' failed\n", __FILE__, __LINE__,\
+                #cond);\
+        return 1;\
+    }\
+} while(0)
+
+#endif /* SCOW_TEST_CHECK_H_ */
@@ -0,0 +1,123 @@
+/*
+ * @file test_dirty_ranges.c
+ * @brief Tests merging of dirty ranges of Buffer
+ *
+ * Copyright 2014 Roman Arzumanyan (roman.arzum@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+// Source under test sets feature macros, so it goes first
+#include "../src/mem_object.c"
+
+#include <string.h>
+
+#include "test_check.h"
+
+/*! \cond PRIVATE */
+// Buffer without OpenCL memory object, only ranges are tracked
+static void Init_Test_Buffer(scow_Mem_Object *buffer, size_t size,
+        size_t granularity)
+{
+    memset(buffer, 0, sizeof(*buffer));
+
+    buffer->obj_mem_type = BUFFER;
+    buffer->size = size;
+    buffer->dirty_granularity = granularity;
+}
+
+static int Has_Range(scow_Mem_Object *buffer, cl_uint index, size_t begin,
+        size_t end)
+{
+    return index < buffer->num_dirty && buffer->dirty[index].begin == begin &&
+            buffer->dirty[index].end == end;
+}
+/*! \endcond */
+
+// Far ranges are kept apart & sorted, close ones are merged
+static int Test_Merge_Close_Ranges()
+{
+    scow_Mem_Object buffer;
+
+    Init_Test_Buffer(&buffer, 100000, 1);
+
+    CHECK(Buffer_Mark_Dirty(&buffer, 5000, 10) == CL_SUCCESS);
+    CHECK(Buffer_Mark_Dirty(&buffer, 100, 10) == CL_SUCCESS);
+    CHECK(buffer.num_dirty == 2);
+    CHECK(Has_Range(&buffer, 0, 100, 110) && Has_Range(&buffer, 1, 5000, 5010));
+
+    // Gap isn't wider than MEM_OBJECT_DIRTY_GAP
+    CHECK(Buffer_Mark_Dirty(&buffer, 110 + MEM_OBJECT_DIRTY_GAP, 10) ==
+            CL_SUCCESS);
+    CHECK(buffer.num_dirty == 2);
+    CHECK(Has_Range(&buffer, 0, 100, 120 + MEM_OBJECT_DIRTY_GAP));
+
+    // Range, which spans both, merges them into one
+    CHECK(Buffer_Mark_Dirty(&buffer, 50, 5000) == CL_SUCCESS);
+    CHECK(buffer.num_dirty == 1 && Has_Range(&buffer, 0, 50, 5050));
+
+    free(buffer.dirty);
+
+    return 0;
+}
+
+// Ranges are widened to granularity & clipped by size of Buffer
+static int Test_Granularity()
+{
+    scow_Mem_Object buffer;
+
+    Init_Test_Buffer(&buffer, 100000, 4096);
+
+    CHECK(Buffer_Mark_Dirty(&buffer, 99000, 100) == CL_SUCCESS);
+    CHECK(buffer.num_dirty == 1 && Has_Range(&buffer, 0, 98304, 100000));
+
+    CHECK(Buffer_Mark_Dirty(&buffer, 99999, 2) == INVALID_BUFFER_SIZE);
+    CHECK(Buffer_Mark_Dirty(&buffer, 0, 0) == INVALID_BUFFER_SIZE);
+    CHECK(buffer.num_dirty == 1);
+
+    free(buffer.dirty);
+
+    return 0;
+}
+
+// List of ranges grows beyond its initial capacity
+static int Test_Many_Ranges()
+{
+    scow_Mem_Object buffer;
+    size_t stride = 2 * MEM_OBJECT_DIRTY_GAP;
+
+    Init_Test_Buffer(&buffer, 64 * stride, 1);
+
+    for (cl_uint i = 64; i-- > 0;)
+    {
+        CHECK(Buffer_Mark_Dirty(&buffer, i * stride, 1) == CL_SUCCESS);
+    }
+
+    CHECK(buffer.num_dirty == 64 && buffer.max_dirty >= 64);
+
+    for (cl_uint i = 0; i < 64; i++)
+    {
+        CHECK(Has_Range(&buffer, i, i * stride, i * stride + 1));
+    }
+
+    free(buffer.dirty);
+
+    return 0;
+}
+
+int main()
+{
+    int num_failed = 0;
+
+    num_failed += Test_Merge_Close_Ranges();
+    num_failed += Test_Granularity();
+    num_failed += Test_Many_Ranges();
+
+    return num_failed ? 1 : 0;
+}